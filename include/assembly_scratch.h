@@ -0,0 +1,346 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef assembly_scratch_h
+#define assembly_scratch_h
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/smartpointer.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping.h>
+
+#include <deal.II/numerics/fe_field_function.h>
+
+#include <memory>
+#include <vector>
+
+#include "cartesian_grid_locator.h"
+
+using namespace dealii;
+using namespace std;
+
+//! Values, gradients and hessians of the shape functions of a
+//! primitive finite element at an arbitrary set of points of a cell of
+//! the control volume. The cell is assumed to be described by the
+//! d-linear mapping, which is the mapping used for the control volume
+//! throughout the code. The interface mimics the one of
+//! <code>FEValues</code>, so that the assembly of the coupling terms
+//! can use either object, but the storage is allocated only once by
+//! <code>initialize()</code> and reused for every set of points.
+template <int dim>
+class PointShapeValues
+{
+public:
+
+  PointShapeValues ();
+
+//! Allocate storage for at most <code>max_points</code> points of the
+//! finite element <code>fe</code>. If <code>hessians</code> is false,
+//! the second derivatives are neither stored nor computed.
+
+  void initialize (const FiniteElement<dim> &fe,
+                   const unsigned int max_points,
+                   const bool hessians);
+
+//! Evaluate the shape functions at the given points, expressed in the
+//! coordinates of the reference cell, of the given cell.
+
+  void reinit (const typename DoFHandler<dim>::active_cell_iterator &cell,
+               const vector< Point<dim> > &unit_points);
+
+  double shape_value (const unsigned int i,
+                      const unsigned int q) const
+  {
+    return values(i,q);
+  };
+
+  const Tensor<1,dim> &shape_grad (const unsigned int i,
+                                   const unsigned int q) const
+  {
+    return gradients(i,q);
+  };
+
+  const Tensor<2,dim> &shape_hessian (const unsigned int i,
+                                      const unsigned int q) const
+  {
+    return hessians(i,q);
+  };
+
+//! Number of points at which the shape functions were last evaluated.
+
+  unsigned int n_quadrature_points;
+
+private:
+
+  SmartPointer<const FiniteElement<dim>, PointShapeValues<dim> > fe;
+
+  bool compute_hessians;
+
+  Table<2, double> values;
+
+  Table<2, Tensor<1,dim> > gradients;
+
+  Table<2, Tensor<2,dim> > hessians;
+};
+
+
+//! Storage for every temporary object used in
+//! <code>IFEM::residual_and_or_Jacobian</code>. One object of this kind
+//! exists for each thread taking part in the assembly. It is sized once
+//! for the largest cell of the fluid and of the solid, so that the
+//! per-cell objects are not rebuilt at every evaluation of the residual
+//! and of the Jacobian. This does not make the assembly free of heap
+//! allocations: the location of the solid quadrature points in the
+//! fluid cells, when <code>FEFieldFunction</code> is used, and the
+//! output of <code>vector_value_list</code> still allocate their own
+//! containers.
+template <int dim>
+struct AssemblyScratch
+{
+  AssemblyScratch ();
+
+//! Build all the objects. The mapping is the one describing the
+//! current configuration of the immersed domain. Hessians of the fluid
+//! shape functions at the solid quadrature points are only computed if
+//! <code>hessians</code> is true.
+
+  void reinit (const FiniteElement<dim> &fe_f,
+               const FiniteElement<dim, dim> &fe_s,
+               const Quadrature<dim> &quad_f,
+               const Quadrature<dim> &quad_s,
+               const Mapping<dim, dim> &immersed_mapping,
+               const bool hessians);
+
+  bool initialized;
+
+  std::unique_ptr<FEValues<dim> > fe_f_v;
+
+  std::unique_ptr<FEValues<dim, dim> > fe_v_s;
+
+  std::unique_ptr<FEValues<dim, dim> > fe_v_s_mapped;
+
+  PointShapeValues<dim> local_fe_f_v;
+
+  vector<unsigned int> dofs_f;
+  vector<unsigned int> dofs_s;
+
+  vector<double> local_res;
+  vector<double> local_pressure_coefficient;
+  FullMatrix<double> local_jacobian;
+
+// Left empty on purpose: it is passed whenever the Jacobian is not
+// requested.
+  FullMatrix<double> no_jacobian;
+
+  vector< Vector<double> > local_force_f;
+  vector< Vector<double> > local_force_s;
+
+  vector< Vector<double> > local_upt;
+  vector< Vector<double> > local_up;
+  vector< vector< Tensor<1,dim> > > local_grad_up;
+  vector< vector< Tensor<1,dim> > > local_grad_upt;
+  vector< vector< Tensor<2,dim> > > local_hessian_up;
+  vector<double> local_div_u;
+
+  vector< Vector<double> > local_Wt;
+  vector< Vector<double> > local_W;
+  vector< vector< Tensor<1,dim> > > H;
+  vector< Tensor<2,dim,double> > Pe;
+  vector< Tensor<2,dim,double> > F;
+  vector< Tensor<2,dim,double> > P;
+  vector< Tensor<2,dim,double> > local_invFT;
+  vector<double> local_J;
+  vector< vector< Tensor<2,dim,double> > > DPeFT_dxi;
+
+// Empty containers, used when the deformation gradient or its
+// derivative are not needed.
+  vector< Tensor<2,dim,double> > no_F;
+  vector< vector< Tensor<2,dim,double> > > no_DPeFT_dxi;
+
+  Vector<double> local_A_gamma;
+  Vector<double> local_M_gamma3_inv_A_gamma;
+};
+
+
+//! Location in the control volume of the quadrature points of the
+//! immersed domain. For each cell of the immersed domain we store the
+//! list of fluid cells containing its quadrature points, the reference
+//! coordinates of the points within those cells, and the index of each
+//! point in the quadrature rule of the solid cell, i.e., the output of
+//! <code>FEFieldFunction::compute_point_locations</code>. The information
+//! depends only on the displacement defining the mapping of the
+//! immersed domain, and it is recomputed only when the latter changes.
+//! If the control volume is a uniform Cartesian grid, as found by
+//! <code>grid</code>, the points are located by the latter instead.
+//!
+//! Quadrature points shared by neighboring cells of the immersed domain,
+//! like those of iterated trapezoidal rules on faces and vertices, are
+//! located only once per update, and their location is shared by all
+//! the cells: the first update builds a table of the distinct points.
+template <int dim>
+class CouplingCache
+{
+public:
+
+  CouplingCache ();
+
+  void initialize (const DoFHandler<dim> &dh_f,
+                   const Vector<double> &up,
+                   const DoFHandler<dim, dim> &dh_s,
+                   const CartesianGridLocator<dim> *grid = 0);
+
+//! Whether the stored locations correspond to the given displacement.
+
+  bool is_up_to_date (const Vector<double> &displacement) const;
+
+//! Locate the quadrature points of all the cells of the immersed
+//! domain. The <code>FEValues</code> object must be built with the mapping
+//! associated with <code>displacement</code> and with
+//! <code>update_quadrature_points</code>.
+
+  void update (FEValues<dim, dim> &fe_v_s_mapped,
+               const Vector<double> &displacement);
+
+  void clear ();
+
+//! Number of times the locations have been computed. It is used to find
+//! out if objects depending on the locations, like the sparsity
+//! pattern, are out of date.
+
+  unsigned int n_updates;
+
+  vector< vector< typename DoFHandler<dim>::active_cell_iterator > > fluid_cells;
+  vector< vector< vector< Point<dim> > > > fluid_qpoints;
+  vector< vector< vector< unsigned int > > > fluid_maps;
+
+private:
+
+  std::unique_ptr<Functions::FEFieldFunction<dim, DoFHandler<dim>, Vector<double> > >
+  locator;
+
+  SmartPointer<const DoFHandler<dim, dim>, CouplingCache<dim> > dh_s;
+
+  SmartPointer<const CartesianGridLocator<dim>, CouplingCache<dim> > grid;
+
+  void build_point_table (const vector< Point<dim> > &all_points,
+                          const double tolerance);
+
+//! Index of the distinct point of each quadrature point of each cell of
+//! the immersed domain, and the fluid cell and reference coordinates of
+//! each distinct point.
+
+  vector< vector<unsigned int> > point_ids;
+
+  vector< typename DoFHandler<dim>::active_cell_iterator > point_cell;
+
+  vector< Point<dim> > point_reference;
+
+//! Current position of the quadrature points, cell by cell, and whether
+//! each distinct point has been located in the current update.
+
+  vector< Point<dim> > points;
+
+  vector<bool> located;
+
+  Vector<double> displacement;
+
+  bool valid;
+};
+
+
+// Values, gradients and hessians of a finite element function at the
+// first <code>n_points</code> points of <code>shapes</code>, which can be
+// either an <code>FEValues</code> or a <code>PointShapeValues</code>
+// object. Unlike the corresponding functions of <code>FEValues</code>,
+// these do not allocate any memory, and the output vectors only need to
+// be at least <code>n_points</code> long.
+
+template <int dim, class ShapeValues, class InputVector>
+void
+get_local_function_values (const ShapeValues &shapes,
+                           const FiniteElement<dim, dim> &fe,
+                           const vector<unsigned int> &dofs,
+                           const InputVector &x,
+                           const unsigned int n_points,
+                           vector< Vector<double> > &values)
+{
+  for (unsigned int q=0; q<n_points; ++q)
+    values[q] = 0;
+
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    {
+      const unsigned int comp_i = fe.system_to_component_index(i).first;
+      const double x_i = x(dofs[i]);
+      for (unsigned int q=0; q<n_points; ++q)
+        values[q](comp_i) += x_i * shapes.shape_value(i,q);
+    }
+}
+
+template <int dim, class ShapeValues, class InputVector>
+void
+get_local_function_gradients (const ShapeValues &shapes,
+                              const FiniteElement<dim, dim> &fe,
+                              const vector<unsigned int> &dofs,
+                              const InputVector &x,
+                              const unsigned int n_points,
+                              vector< vector< Tensor<1,dim> > > &gradients)
+{
+  for (unsigned int q=0; q<n_points; ++q)
+    for (unsigned int c=0; c<gradients[q].size(); ++c)
+      gradients[q][c] = 0;
+
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    {
+      const unsigned int comp_i = fe.system_to_component_index(i).first;
+      const double x_i = x(dofs[i]);
+      for (unsigned int q=0; q<n_points; ++q)
+        gradients[q][comp_i] += x_i * shapes.shape_grad(i,q);
+    }
+}
+
+template <int dim, class ShapeValues, class InputVector>
+void
+get_local_function_hessians (const ShapeValues &shapes,
+                             const FiniteElement<dim, dim> &fe,
+                             const vector<unsigned int> &dofs,
+                             const InputVector &x,
+                             const unsigned int n_points,
+                             vector< vector< Tensor<2,dim> > > &hessians)
+{
+  for (unsigned int q=0; q<n_points; ++q)
+    for (unsigned int c=0; c<hessians[q].size(); ++c)
+      hessians[q][c] = 0;
+
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    {
+      const unsigned int comp_i = fe.system_to_component_index(i).first;
+      const double x_i = x(dofs[i]);
+      for (unsigned int q=0; q<n_points; ++q)
+        hessians[q][comp_i] += x_i * shapes.shape_hessian(i,q);
+    }
+}
+
+#endif
@@ -0,0 +1,141 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef boundary_data_cache_h
+#define boundary_data_cache_h
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/smartpointer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/mapping.h>
+#include <deal.II/fe/component_mask.h>
+
+#include <map>
+#include <vector>
+
+#include "dense_boundary_values.h"
+
+using namespace dealii;
+using namespace std;
+
+//! Dirichlet data of the control volume. The boundary dofs, together
+//! with their support points and vector components, are found once by
+//! <code>initialize()</code>, so that the boundary values at a given time
+//! are obtained by evaluating the boundary functions at a list of points,
+//! without looping over the boundary faces of the triangulation.
+//!
+//! Only one of the boundary functions is allowed to depend on time. The
+//! caller may declare it of the form $g(t)\,\mathbf{u}(\mathbf{x})$, as is
+//! the case, e.g., for a ramped inflow profile. Its values at the
+//! boundary dofs, the first time they do not vanish, are then stored as
+//! the profile, and the boundary data at later times only require the
+//! scalar factor $g(t)$, computed from the value of the function at a
+//! single dof. The value at a second dof is used at every time step as a
+//! sanity check of the declaration; if it fails, the function is
+//! evaluated at all the boundary dofs from then on. The check cannot
+//! prove that the data are separable, which is why this is never
+//! assumed without the declaration.
+template <int dim>
+class BoundaryDataCache
+{
+public:
+
+  BoundaryDataCache ();
+
+//! Find the dofs constrained by <code>function_map</code>, as
+//! <code>VectorTools::interpolate_boundary_values</code> would do.
+//! <code>time_dependent_function</code> is the only function of the map
+//! whose time is changed by <code>evaluate()</code>, and
+//! <code>separable</code> declares it of the form above.
+
+  void initialize (const Mapping<dim> &mapping,
+                   const DoFHandler<dim> &dh,
+                   const map<types::boundary_id, const Function<dim> *> &function_map,
+                   const ComponentMask &component_mask,
+                   Function<dim> &time_dependent_function,
+                   const bool separable);
+
+//! Store in <code>boundary_values</code> the boundary data at time
+//! <code>t</code>. Nothing is done if the data were already computed for
+//! the same time.
+
+  void evaluate (const double t,
+                 DenseBoundaryValues &boundary_values);
+
+//! Forget the time of the last evaluation, so that the next call to
+//! <code>evaluate()</code> writes all the values again.
+
+  void invalidate ();
+
+  bool is_separable () const
+  {
+    return separable;
+  };
+
+  unsigned int n_boundary_dofs () const
+  {
+    return dofs.size();
+  };
+
+//! Number of evaluations of the time dependent function since the last
+//! call to <code>initialize()</code>.
+
+  unsigned int n_function_evaluations;
+
+private:
+
+//! Store the current values as the profile of separable data, unless
+//! they all vanish.
+
+  void set_profile ();
+
+//! Evaluate the time dependent function at all the boundary dofs
+//! depending on it.
+
+  void evaluate_all (const double t,
+                     vector<double> &v);
+
+  SmartPointer<Function<dim>, BoundaryDataCache<dim> > function;
+
+  vector<unsigned int> dofs;
+
+  vector< Point<dim> > points;
+
+  vector<unsigned int> components;
+
+  vector<bool> time_dependent;
+
+  vector<double> values;
+
+// Values of the time dependent function at the first instant in which
+// they do not vanish, used as the spatial profile when the data are
+// separable. It is empty until then.
+  vector<double> profile;
+
+// The entries used to compute, and to check, the time factor.
+  unsigned int reference;
+
+  unsigned int check;
+
+  bool separable;
+
+  bool has_values;
+
+  double current_time;
+};
+
+#endif
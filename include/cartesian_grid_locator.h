@@ -0,0 +1,93 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef cartesian_grid_locator_h
+#define cartesian_grid_locator_h
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Location of points in a uniform Cartesian grid, i.e. a triangulation
+//! whose active cells are equal boxes aligned with the coordinate axes,
+//! with their vertices numbered in the same directions as the axes, and
+//! filling a box. This is, e.g., a subdivided hyper rectangle refined
+//! globally. The cell containing a point and the coordinates of the
+//! point in it then follow from the coordinates of the point, without
+//! any search in the triangulation.
+template <int dim>
+class CartesianGridLocator : public Subscriptor
+{
+public:
+
+  typedef typename DoFHandler<dim>::active_cell_iterator cell_iterator;
+
+  CartesianGridLocator ();
+
+//! Find out if the triangulation of <code>dh</code> is a uniform Cartesian
+//! grid and, if so, store its cells in lexicographic order. Return
+//! <code>is_cartesian()</code>.
+
+  bool initialize (const DoFHandler<dim> &dh);
+
+  void clear ();
+
+  bool is_cartesian () const
+  {
+    return !cells.empty();
+  };
+
+//! The cell containing <code>p</code>, and the coordinates of
+//! <code>p</code> in its reference cell. Return false if the point is
+//! outside of the grid.
+
+  bool locate (const Point<dim> &p,
+               cell_iterator &cell,
+               Point<dim> &unit_point) const;
+
+//! The same output as <code>FEFieldFunction::compute_point_locations</code>:
+//! the cells containing the points, and for each cell, the reference
+//! coordinates of its points and their indices in <code>points</code>.
+//! An exception is thrown if a point is outside of the grid.
+
+  unsigned int
+  compute_point_locations (const vector< Point<dim> > &points,
+                           vector<cell_iterator> &point_cells,
+                           vector< vector< Point<dim> > > &qpoints,
+                           vector< vector<unsigned int> > &maps) const;
+
+private:
+
+  unsigned int cell_index (const Point<dim> &p,
+                           Point<dim> &unit_point) const;
+
+  Point<dim> lower_corner;
+
+  Point<dim> cell_size;
+
+  unsigned int n_cells[dim];
+
+  double tolerance;
+
+  vector<cell_iterator> cells;
+};
+
+#endif
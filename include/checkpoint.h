@@ -0,0 +1,158 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef checkpoint_h
+#define checkpoint_h
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Version of the format of the checkpoint files. It must be increased
+//! whenever the data written by <code>IFEM::serialize_state</code>
+//! change, so that old files are rejected rather than misread.
+
+const unsigned int checkpoint_format_version = 3;
+
+
+//! Write a checkpoint file: a header, made of a magic string, the
+//! version of the format, the size of the data and their checksum,
+//! followed by the data themselves, usually a binary archive. The file
+//! is first written under a temporary name and then renamed, so that an
+//! interrupted write never leaves a truncated checkpoint behind.
+
+void write_checkpoint (const string &filename,
+                       const string &data);
+
+
+//! Read the data of a checkpoint file. An exception is thrown if the
+//! file is not a checkpoint, was written with another version of the
+//! format, is truncated, or its checksum does not match its data.
+
+string read_checkpoint (const string &filename);
+
+
+//! Whether the file exists and can be read.
+
+bool file_exists (const string &filename);
+
+
+//! 64-bit FNV-1a hash of a sequence of bytes.
+
+uint64_t fnv1a_checksum (const char *data,
+                         const size_t size);
+
+
+//! Names of the complete checkpoints with the given prefix, oldest
+//! first, as listed by <code>CheckpointWriter</code>. A checkpoint is
+//! complete if its completion marker exists.
+
+vector<string> complete_checkpoints (const string &prefix);
+
+
+//! Writer of a rotating series of checkpoints. Each checkpoint is the
+//! file <code>prefix + "checkpoint-NNNNN.bin"</code>, NNNNN being the time
+//! step, and it is complete when the marker with the additional suffix
+//! <code>.done</code> exists. The complete checkpoints are listed, oldest
+//! first, in <code>prefix + "checkpoints.txt"</code>, and only the last
+//! <code>n_kept</code> are kept on disk.
+//!
+//! In the background mode the files are written by a separate task,
+//! while the computation goes on. The data passed to <code>write()</code>
+//! must therefore be a snapshot of the state, which is not changed
+//! afterwards.
+class CheckpointWriter
+{
+public:
+
+  CheckpointWriter ();
+
+//! Wait for the checkpoint being written, if any. A failure to write it
+//! is reported on <code>cerr</code>.
+
+  ~CheckpointWriter ();
+
+//! Set the prefix of the files and the way they are written. The
+//! checkpoints already listed with this prefix become part of the
+//! series, so that the rotation continues after a restart.
+
+  void initialize (const string &prefix,
+                   const unsigned int n_kept,
+                   const bool background);
+
+//! Record that the computation restarts from the checkpoint
+//! <code>name</code>. The later checkpoints of the series, which were not
+//! read or belong to the discarded part of the run, are no longer listed,
+//! and their files are removed at the next rotation.
+
+  void restored (const string &name);
+
+//! Write <code>data</code> as the checkpoint of the given time step.
+//! The content of <code>data</code> is taken over, and the string is left
+//! empty. In the background mode, the function returns as soon as the
+//! previous checkpoint is complete, and throws if writing it failed.
+
+  void write (const unsigned int time_step,
+              string &data);
+
+//! Wait until the last checkpoint is complete. If it was written in the
+//! background and that failed, the error is thrown from here.
+
+  void wait ();
+
+//! Time step of the last checkpoint requested, or
+//! <code>numbers::invalid_unsigned_int</code> if there is none.
+
+  unsigned int last_time_step () const
+  {
+    return last_step;
+  };
+
+private:
+
+  void write_and_rotate ();
+
+  void write_in_background ();
+
+  string prefix;
+
+  unsigned int n_kept;
+
+  bool background;
+
+  unsigned int last_step;
+
+  deque<string> kept;
+
+  vector<string> discarded;
+
+  string pending_name;
+
+  string pending_data;
+
+  string background_error;
+
+  Threads::Task<void> task;
+};
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef dense_boundary_values_h
+#define dense_boundary_values_h
+
+#include <deal.II/base/exceptions.h>
+
+#include <map>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Dirichlet boundary values stored by dof index. Besides the value,
+//! each dof has a flag telling whether it is constrained, so that the
+//! question "is this dof constrained, and to what value?" costs an
+//! indexed load instead of a search in a <code>std::map</code>. The list of
+//! the constrained dofs is also kept, for the operations that only
+//! concern them.
+class DenseBoundaryValues
+{
+public:
+
+//! Set the number of dofs and remove all the constraints.
+
+  void reinit (const unsigned int n_dofs);
+
+//! Replace the current constraints with the ones in the map returned
+//! by <code>VectorTools::interpolate_boundary_values</code>.
+
+  void set (const map<unsigned int, double> &boundary_values);
+
+//! Constrain a single dof, or change its value if it is already
+//! constrained.
+
+  void set (const unsigned int dof,
+            const double value)
+  {
+    Assert (dof < values.size(), ExcIndexRange (dof, 0, values.size()));
+    if (!constrained[dof])
+      {
+        constrained[dof] = true;
+        dofs.push_back (dof);
+      }
+    values[dof] = value;
+  };
+
+  bool is_constrained (const unsigned int dof) const
+  {
+    return constrained[dof];
+  };
+
+  double value (const unsigned int dof) const
+  {
+    return values[dof];
+  };
+
+//! The constrained dofs, in the order in which they were set.
+
+  const vector<unsigned int> &constrained_dofs () const
+  {
+    return dofs;
+  };
+
+  unsigned int size () const
+  {
+    return values.size();
+  };
+
+private:
+
+  vector<double> values;
+
+  vector<bool> constrained;
+
+  vector<unsigned int> dofs;
+};
+
+#endif
@@ -0,0 +1,181 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef direct_solver_h
+#define direct_solver_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/block_sparse_matrix.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Common interface of the sparse direct solvers used to invert the
+//! Jacobian and the mass matrix of the immersed domain. Objects are
+//! built by <code>create_direct_solver()</code>, given the name of the
+//! backend. Besides solving, each backend records the cost of its
+//! factorizations: time, peak memory, and number of nonzero entries of
+//! the factors, when the underlying library makes them available.
+class DirectSolver : public Subscriptor
+{
+public:
+
+  struct Statistics
+  {
+    Statistics ();
+
+    unsigned int n_factorizations;
+
+    double last_factorization_time;
+
+    double total_factorization_time;
+
+//! Nonzero entries of the last matrix and of its factors. The latter is
+//! zero if the backend does not report it.
+
+    double matrix_nonzeros;
+
+    double factor_nonzeros;
+
+//! Floating point operations of the last factorization, or zero if the
+//! backend does not report them.
+
+    double flops;
+
+//! Largest memory, in bytes, used by a factorization, or zero if the
+//! backend does not report it.
+
+    double peak_memory;
+  };
+
+//! Fill-reducing orderings of the columns. With <code>automatic</code>
+//! the backend uses its default strategy; with <code>natural</code> the
+//! columns are not permuted; with <code>given</code> they are taken in
+//! the order passed to <code>set_ordering()</code>.
+
+  enum Ordering
+  {
+    automatic,
+    natural,
+    amd,
+    metis,
+    given
+  };
+
+  DirectSolver ();
+
+  virtual ~DirectSolver ();
+
+//! Set the ordering used by the next factorizations. Backends that
+//! choose their own ordering ignore this request.
+
+  virtual void set_ordering (const Ordering ordering,
+                             const vector<unsigned int> &columns = vector<unsigned int>());
+
+//! Name of the backend.
+
+  virtual string name () const = 0;
+
+//! Compute the factorization of a matrix. Any previous factorization is
+//! released.
+
+  virtual void initialize (const SparseMatrix<double> &matrix) = 0;
+
+  virtual void initialize (const BlockSparseMatrix<double> &matrix) = 0;
+
+//! Solve with the right hand side and the solution stored
+//! contiguously, each with as many entries as the rows of the matrix.
+//! The two arrays must not overlap. This is the only function a backend
+//! needs to implement to solve: the ones below only rearrange the
+//! storage of the vectors, when needed, and call it.
+
+  virtual void solve (double *solution,
+                      const double *rhs) const = 0;
+
+//! Overwrite the right hand side with the solution.
+
+  void solve (Vector<double> &rhs_and_solution) const;
+
+  void solve (BlockVector<double> &rhs_and_solution) const;
+
+//! Application of the inverse, so that the solver can be used as a
+//! preconditioner. The storage of a <code>Vector</code>, and of a
+//! <code>BlockVector</code> with a single block, is passed to the
+//! backend without copies. The blocks of other block vectors are
+//! gathered into contiguous storage and scattered back.
+
+  void vmult (Vector<double> &dst,
+              const Vector<double> &src) const;
+
+  void vmult (BlockVector<double> &dst,
+              const BlockVector<double> &src) const;
+
+  const Statistics &statistics () const
+  {
+    return stats;
+  };
+
+//! Write the statistics on one line, preceded by <code>label</code>.
+
+  void print_statistics (ostream &out,
+                         const string &label) const;
+
+protected:
+
+  Statistics stats;
+
+  Ordering ordering;
+
+  vector<unsigned int> given_ordering;
+
+  mutable Vector<double> tmp;
+
+  mutable Vector<double> tmp_solution;
+};
+
+
+//! Names of the backends available in this build, separated by
+//! <code>|</code>, as needed by <code>Patterns::Selection</code>.
+
+string direct_solver_names ();
+
+
+//! Backend used when none is requested: UMFPACK if deal.II was configured
+//! with it, KLU through Amesos otherwise.
+
+string default_direct_solver ();
+
+
+//! Names of the orderings, as above, and conversion to the enum.
+
+string direct_solver_ordering_names ();
+
+DirectSolver::Ordering direct_solver_ordering (const string &name);
+
+
+//! Build the direct solver with the given name.
+
+std::unique_ptr<DirectSolver> create_direct_solver (const string &name);
+
+#endif
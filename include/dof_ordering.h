@@ -0,0 +1,80 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef dof_ordering_h
+#define dof_ordering_h
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Names of the renumbering strategies accepted by
+//! <code>renumber_dofs()</code>, separated by <code>|</code>.
+
+string dof_renumbering_names ();
+
+
+//! Renumber the dofs of <code>dh</code> with one of the bandwidth or
+//! fill reducing algorithms of the Boost graph library: "Cuthill-McKee",
+//! "King", or "Minimum degree". The same function must be used by all
+//! the objects reading the same solution vectors.
+
+template <int dim>
+void renumber_dofs (DoFHandler<dim> &dh,
+                    const string &strategy);
+
+
+//! Order in which the columns of the monolithic Jacobian, whose
+//! velocity, pressure, and displacement dofs are numbered consecutively
+//! in this order, are presented to the direct solver: the velocity and
+//! pressure dofs are interleaved, each keeping the relative order given
+//! by the renumbering of the control volume, and the displacement dofs
+//! follow.
+
+void block_interleaved_ordering (const unsigned int n_dofs_u,
+                                 const unsigned int n_dofs_p,
+                                 const unsigned int n_dofs_W,
+                                 vector<unsigned int> &ordering);
+
+
+//! Joint ordering of the dofs of the control volume and of the immersed
+//! domain: each displacement dof is placed right after the first dof of
+//! the control volume it is coupled to, according to the coupling block
+//! <code>solid_fluid</code> of the sparsity pattern. Displacement dofs
+//! that are not coupled to any fluid dof are placed at the end.
+
+void joint_fluid_solid_ordering (const unsigned int n_dofs_up,
+                                 const SparsityPattern &solid_fluid,
+                                 vector<unsigned int> &ordering);
+
+
+//! Ordering for a discontinuous pressure, whose dofs belong to a single
+//! cell: the cells of the control volume are visited in the order of
+//! their first velocity dof, and the velocity dofs of each cell not
+//! already placed are followed by the pressure dofs of the cell. The
+//! factorization thus eliminates the pressure of each cell along with
+//! the velocity around it. The <code>n_dofs_W</code> displacement dofs
+//! follow the dofs of <code>dh</code>.
+
+template <int dim>
+void cell_local_pressure_ordering (const DoFHandler<dim> &dh,
+                                   const unsigned int n_dofs_W,
+                                   vector<unsigned int> &ordering);
+
+#endif
@@ -0,0 +1,99 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef fluid_refinement_h
+#define fluid_refinement_h
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe.h>
+
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <string>
+#include <vector>
+
+#include "ifem_parameters.h"
+
+using namespace dealii;
+using namespace std;
+
+//! Flag for refinement the active cells of <code>dh</code> containing
+//! any of the <code>points</code>, and then, <code>n_layers</code> times,
+//! the cells sharing a vertex with a flagged cell. All the points must be
+//! in the domain of <code>dh</code>.
+
+template <int dim>
+void flag_cells_around_points (const DoFHandler<dim> &dh,
+                               const vector< Point<dim> > &points,
+                               const unsigned int n_layers);
+
+
+//! Flag for refinement the fraction <code>fraction</code> of the active
+//! cells of <code>dh</code> with the largest Kelly indicator of the
+//! velocity, i.e. of the first <code>dim</code> components of
+//! <code>up</code>. Flags already set are kept.
+
+template <int dim>
+void flag_cells_by_kelly_estimator (const DoFHandler<dim> &dh,
+                                    const Vector<double> &up,
+                                    const double fraction);
+
+
+//! Flags for the remeshing of the control volume following the immersed
+//! domain: the cells flagged by the two functions above are refined, if
+//! their level is lower than <code>max_level</code>, and the others are
+//! coarsened, if their level is higher than <code>min_level</code>.
+
+template <int dim>
+void flag_cells_for_remeshing (const DoFHandler<dim> &dh,
+                               const vector< Point<dim> > &points,
+                               const Vector<double> &up,
+                               const unsigned int n_layers,
+                               const double kelly_fraction,
+                               const unsigned int min_level,
+                               const unsigned int max_level);
+
+
+//! Local refinement of the control volume around the immersed domain,
+//! after the global refinement of both triangulations. Each of the
+//! <code>par.adaptive_cycles_f</code> cycles refines the fluid cells
+//! containing the points of <code>quad_s</code> on the cells of
+//! <code>tria_s</code>, displaced by the initial displacement, the
+//! <code>par.buffer_layers_f</code> layers of cells around them, and the
+//! cells flagged by the Kelly estimator of the initial velocity.
+
+template <int dim>
+void refine_around_immersed_domain (Triangulation<dim> &tria_f,
+                                    const Triangulation<dim> &tria_s,
+                                    const FiniteElement<dim> &fe_f,
+                                    const Quadrature<dim> &quad_s,
+                                    const IFEMParameters<dim> &par);
+
+
+//! Description of everything the local refinement depends on, to be
+//! added to the key of a setup cache: its parameters, the initial
+//! conditions, and the quadrature of the immersed domain, whose points
+//! are the ones refined around. It is empty if there is no local
+//! refinement.
+
+template <int dim>
+string local_refinement_description (IFEMParameters<dim> &par);
+
+#endif
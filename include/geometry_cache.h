@@ -0,0 +1,95 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef geometry_cache_h
+#define geometry_cache_h
+
+#include <deal.II/base/types.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Geometric information about a triangulation that does not change
+//! unless the triangulation does: extreme cell diameters, total
+//! measure, and the faces on the boundary, grouped by boundary and by
+//! manifold indicator. The cells are those of a
+//! <code>DoFHandler</code>, so that they can be used directly to
+//! reinitialize <code>FEValues</code> and <code>FEFaceValues</code>
+//! objects. <code>initialize()</code> must be called again whenever the
+//! triangulation or the dofs change.
+template <int dim>
+class GeometryCache
+{
+public:
+
+  typedef typename DoFHandler<dim>::active_cell_iterator cell_iterator;
+
+//! A face of a cell, given by the cell and the index of the face
+//! within it.
+
+  typedef std::pair<cell_iterator, unsigned int> CellFace;
+
+  GeometryCache ();
+
+  void initialize (const DoFHandler<dim> &dh);
+
+//! Boundary faces with the given boundary indicator. The list is empty
+//! if there are none.
+
+  const vector<CellFace> &faces_with_boundary_id (const types::boundary_id id) const;
+
+//! Boundary faces with the given manifold indicator. The list is empty
+//! if there are none.
+
+  const vector<CellFace> &faces_with_manifold_id (const types::manifold_id id) const;
+
+//! Cells having at least one boundary face with the given manifold
+//! indicator, each listed once.
+
+  const vector<cell_iterator> &cells_with_manifold_id (const types::manifold_id id) const;
+
+  double min_diameter;
+
+  double max_diameter;
+
+//! Volume (area in 2D) of the triangulation.
+
+  double measure;
+
+//! All the boundary faces, in the order of the active cells.
+
+  vector<CellFace> boundary_faces;
+
+private:
+
+  map<types::boundary_id, vector<CellFace> > faces_by_boundary_id;
+
+  map<types::manifold_id, vector<CellFace> > faces_by_manifold_id;
+
+  map<types::manifold_id, vector<cell_iterator> > cells_by_manifold_id;
+
+// Returned when a list is not present in the maps above.
+  const vector<CellFace> no_faces;
+
+  const vector<cell_iterator> no_cells;
+};
+
+#endif
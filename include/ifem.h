@@ -25,6 +25,8 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/patterns.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/timer.h>
 
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/sparse_matrix.h>
@@ -59,23 +61,45 @@
 #include <deal.II/numerics/matrix_tools.h>
 #include <deal.II/numerics/fe_field_function.h>
 #include <deal.II/numerics/data_out.h>
+#include <deal.II/numerics/solution_transfer.h>
 
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
 
 // Elements of the C++ standard library
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <set>
 #include <map>
 #include <cmath>
 #include <typeinfo>
+#include <algorithm>
 
 // Our own include files
 #include "ifem_parameters.h"
 #include "exact_solution_ring_with_fibers.h"
+#include "assembly_scratch.h"
+#include "dense_boundary_values.h"
+#include "boundary_data_cache.h"
+#include "geometry_cache.h"
+#include "point_probe.h"
+#include "point_source_set.h"
+#include "newton_policy.h"
+#include "inexact_newton.h"
+#include "jacobian_free.h"
+#include "direct_solver.h"
+#include "dof_ordering.h"
+#include "vector_kernels.h"
+#include "checkpoint.h"
+#include "setup_cache.h"
+#include "fluid_refinement.h"
 
 using namespace std;
 
@@ -170,7 +194,11 @@ private:
   // describe quantities defined over the immersed domain according to
   // an Eulerian view. It is therefore convenient to define a
   // <code>MappingQEulerian</code> object that will support such a
-  // description.
+  // description.  The mapping is built only once, and it refers to
+  // <code>mapping_displacement</code>, which is overwritten whenever the
+  // configuration of the immersed domain changes.
+
+  Vector<double> mapping_displacement;
 
   std::unique_ptr<MappingQEulerian<dim, Vector<double>, dim> > mapping;
 
@@ -185,16 +213,35 @@ private:
   Quadrature<dim> quad_s;
 
 
-  // Constraints matrix for the control volume.
+  // Constraints matrix for the control volume, which only holds the
+  // hanging node constraints, and the dofs it constrains.
 
   ConstraintMatrix constraints_f;
 
+  vector<unsigned int> hanging_dofs_f;
+
 
   // Constraints matrix for the immersed domain.
 
   ConstraintMatrix constraints_s;
 
 
+  // Current Dirichlet boundary values of the control volume and of the
+  // immersed domain, indexed by dof. They are the ones used during the
+  // assembly.
+
+  DenseBoundaryValues dense_boundary_values;
+
+  DenseBoundaryValues dense_boundary_values_solid;
+
+
+  // Boundary dofs of the control volume with their support points, and
+  // the time dependence of <code>par.u_g</code>. Used by
+  // <code>compute_current_bc</code> to fill <code>dense_boundary_values</code>.
+
+  BoundaryDataCache<dim> boundary_data;
+
+
   // Sparsity pattern.
 
   BlockSparsityPattern sparsity;
@@ -212,6 +259,17 @@ private:
   BlockSparseMatrix<double> dummy_JF;
 
 
+  // In the Jacobian-free mode, JF is never built. The fluid block of the
+  // Jacobian, without the contribution of the immersed domain, is
+  // assembled in JF_fluid, whose only block has the sparsity pattern of
+  // sparsity.block(0,0), and its factorization preconditions the
+  // finite-difference Jacobian.
+
+  BlockSparsityPattern fluid_sparsity;
+
+  BlockSparseMatrix<double> JF_fluid;
+
+
   // State of the system at current time step: velocity, pressure, and
   // displacement of the immersed domain.
 
@@ -261,8 +319,24 @@ private:
   Vector<double> tmp_vec_n_dofs_W;
 
 
-  // Matrix to be inverted when solving the problem.
-  SparseDirectUMFPACK JF_inv;
+  // Factorization of the matrix to be inverted when solving the
+  // problem. The backend is chosen in the parameter file.
+  std::unique_ptr<DirectSolver> JF_inv;
+
+
+  // Columns of the Jacobian in the order in which they are factorized,
+  // when the ordering is computed here rather than by the solver.
+  vector<unsigned int> factorization_columns;
+
+
+  // Decides when <code>JF_inv</code> is refreshed and when the Newton
+  // iteration has converged, and counts refreshes and reuses.
+  NewtonPolicy newton_policy;
+
+
+  // Relative accuracy of the Newton updates when these are computed
+  // with an iterative solver.
+  ForcingTerm forcing_term;
 
 
   // Scalar used for conditioning purposes.
@@ -280,6 +354,10 @@ private:
   // A container to store the dofs corresponding to the pressure field.
   std::set<unsigned int> pressure_dofs;
 
+  // Integrals of the shape functions of the pressure dofs, used to
+  // compute the average pressure when the latter is projected out.
+  Vector<double> pressure_weights;
+
 
   // Storage for the elasticity operator of the immersed domain.
   Vector <double> A_gamma;
@@ -290,31 +368,79 @@ private:
 
 
   // Inverse of M_gamma3.
-  SparseDirectUMFPACK M_gamma3_inv;
+  std::unique_ptr<DirectSolver> M_gamma3_inv;
 
 
   // M_gamma3_inv * A_gamma.
   Vector <double> M_gamma3_inv_A_gamma;
 
 
+  // Operator and preconditioner of the Krylov solver in the
+  // Jacobian-free mode, and temporary vectors used to evaluate the
+  // residuals. The preconditioner refers to JF_inv and M_gamma3_inv,
+  // so it is declared after them.
+  FiniteDifferenceJacobian<IFEM<dim> > fd_jacobian;
+
+  BlockDiagonalPreconditioner jacobian_free_preconditioner;
+
+  BlockVector<double> jacobian_free_xit;
+
+  BlockVector<double> fluid_res;
+
+  friend class FiniteDifferenceJacobian<IFEM<dim> >;
+
+
   //Vector to store the volume flux due to the point-source
   Vector <double> volume_flux;
 
 
+  // The point sources, with the nonzero entries of their point source
+  // vectors. The sources do not move, so these are computed once.
+  PointSourceSet<dim> point_sources;
+
+
   // Area of the control volume.
   double area;
 
 
+  // Diameters, measure and boundary faces of the two triangulations.
+  // They are computed once, after the distribution of the dofs.
+  GeometryCache<dim> fluid_geometry;
+
+  GeometryCache<dim> solid_geometry;
+
+
   // File stream that is used to output a file containing information
   // about the fluid flux, area and the centroid of the immersed domain
   // over time.
   ofstream global_info_file;
 
+  // Index of the solution frames written by <code>output_step</code>: the
+  // step, time and time step size of each of them, so that a computation
+  // can be restarted from any of them.
+  ofstream steps_file;
+
   // File stream that is used to output a file containing information
   // about the tip displacement of the flag in the Turek-Hron FSI Benchmark
   ofstream fsi_bm_out_file;
 
 
+  // Points A and B of the Turek-Hron benchmarks, and the points listed
+  // in the "Probes" subsection of the parameter file. They are located
+  // in the meshes once, by <code>initialize_probes</code>.
+  PointProbe<dim> probe_A;
+
+  PointProbe<dim> probe_B;
+
+  vector< PointProbe<dim> > fluid_probes;
+
+  vector< PointProbe<dim> > solid_probes;
+
+
+  // File stream with the values of the fields at the probes over time.
+  ofstream probes_out_file;
+
+
   //Variable to store the current_time;
   double current_time;
 
@@ -327,6 +453,54 @@ private:
   double dt;
 
 
+  // Cells of the control volume in lexicographic order, if it is a
+  // uniform Cartesian grid.
+  CartesianGridLocator<dim> fluid_grid;
+
+
+  // Locations of the quadrature points of the immersed domain in the
+  // control volume. They are recomputed only when the displacement
+  // defining <code>mapping</code> changes.
+  CouplingCache<dim> coupling;
+
+
+  // Value of <code>coupling.n_updates</code> when the coupling blocks of
+  // the sparsity pattern were last computed.
+  unsigned int sparsity_coupling_stamp;
+
+  // Whether the fluid and solid blocks of the sparsity pattern were read
+  // from the checkpoint of a restart.
+  bool sparsity_from_checkpoint;
+
+  // Name and content of the checkpoint a restart starts from. The
+  // content is released once the state has been read.
+  string restart_checkpoint;
+
+  string restart_data;
+
+  // Whether the triangulation of the control volume, remeshed by the run
+  // that wrote the checkpoint, was read from it, and the numbering of its
+  // dofs.
+  bool fluid_mesh_from_checkpoint;
+
+  vector<types::global_dof_index> restored_numbering_f;
+
+  // Triangulations, numbering of the dofs and sparsity patterns saved
+  // by a previous run with the same setup.
+  SetupCache<dim> setup_cache;
+
+  // Writer of the series of checkpoints, and time since the last one.
+  CheckpointWriter checkpoint_writer;
+
+  Timer checkpoint_timer;
+
+
+  // Per-thread storage of the temporary objects needed in the assembly
+  // of the residual and of the Jacobian. It is declared after all the
+  // objects it refers to, so that it is destroyed before them.
+  Threads::ThreadLocalStorage<AssemblyScratch<dim> > scratch;
+
+
   //The following be necessary for serialization purposes
   friend class boost::serialization::access;
 
@@ -348,19 +522,40 @@ private:
     BlockVector<double> &vec,
     const double time);
 
-  void assemble_sparsity (Mapping<dim, dim> &mapping);
+  void initialize_boundary_data ();
+
+  void make_fluid_sparsity_pattern (DynamicSparsityPattern &dsp);
+
+  void assemble_sparsity ();
+
+  bool immersed_domain_left_refined_region () const;
+
+  void remesh_fluid ();
+
+  void update_mapping_and_coupling (const Vector<double> &displacement);
+
+  AssemblyScratch<dim> &get_scratch ();
 
   void  get_area_and_first_pressure_dof ();
 
+  void remove_average_pressure (Vector<double> &up) const;
+
   void residual_and_or_Jacobian (
     BlockVector<double> &residual,
     BlockSparseMatrix<double> &Jacobian,
     const BlockVector<double> &xit,
     const BlockVector<double> &xi,
     const double alpha,
-    const double t
+    const double t,
+    const bool fluid_only = false
   );
 
+  void evaluate_residual (const BlockVector<double> &xi,
+                          const double t,
+                          BlockVector<double> &residual);
+
+  void assemble_fluid_jacobian (const double t);
+
   void distribute_residual (
     Vector<double> &residual,
     const vector<double> &local_res,
@@ -377,6 +572,12 @@ private:
     const unsigned int offset_2
   );
 
+  void apply_hanging_node_constraints (
+    BlockVector<double> &residual,
+    BlockSparseMatrix<double> &jacobian,
+    const Vector<double> &up
+  );
+
   void distribute_constraint_on_pressure (
     Vector<double> &residual,
     const double average_pressure
@@ -399,7 +600,8 @@ private:
     const FEValues<dim,dim> &fe_v_s,
     const vector< unsigned int > &dofs,
     const Vector<double> &xi,
-    Vector<double> &local_A_gamma
+    Vector<double> &local_A_gamma,
+    AssemblyScratch<dim> &scratch_data
   );
 
   template <class FEVal>
@@ -410,7 +612,8 @@ private:
     const bool update_jacobian,
     vector<Tensor<2,dim,double> > &Pe,
     vector<Tensor<2,dim,double> > &F,
-    vector< vector<Tensor<2,dim,double> > > &DPe_dxi
+    vector< vector<Tensor<2,dim,double> > > &DPe_dxi,
+    vector< vector< Tensor<1,dim> > > &H
   );
 
   void get_inverse_transpose (
@@ -418,6 +621,12 @@ private:
     vector < Tensor <2, dim> > &local_invFT
   );
 
+  void factorize_jacobian ();
+
+  void set_factorization_ordering ();
+
+  void initialize_point_sources ();
+
   void get_volume_flux_vector (const double t);
 
   void calculate_error () const;
@@ -450,13 +659,26 @@ private:
 
   void fsi_bm_postprocess2();
 
+  void initialize_probes ();
+
+  void write_probes (const double t);
+
   template <class Archive>
   void serialize(Archive &ar, const unsigned int version);
 
+  template <class Archive>
+  void serialize_state (Archive &ar);
+
+  bool restore_fluid_mesh ();
+
   void restart_computations();
 
+  void restart_from_frame ();
+
   void save_for_restart();
 
+  bool checkpoint_due () const;
+
 };
 
 #endif
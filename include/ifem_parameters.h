@@ -19,10 +19,20 @@
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/parsed_function.h>
 
+#include "point_source_set.h"
+
 using namespace dealii;
 using namespace dealii::Functions;
 using namespace std;
 
+//! Largest number of point sources that can be listed, each with its own
+//! strength function, in the parameter file. A subsection is declared,
+//! and printed in the default parameter files, for each of them. There
+//! is no limit on the sources read from the point source file, where
+//! each line carries the factor multiplying the strength of its source.
+
+const unsigned int max_listed_point_sources = 4;
+
 //! This class collects all of the user-specified parameters, both
 //! pertaining to physics of the problem (e.g., shear modulus, dynamic
 //! viscosity), and to other numerical aspects of the simulation (e.g.,
@@ -124,6 +134,22 @@ public:
   unsigned int ref_s;
 
 
+// Local refinement of the control volume around the immersed domain:
+// number of cycles, layers of cells refined around the cells containing
+// the immersed domain, and fraction of the cells refined according to
+// the Kelly estimator. The control volume is remeshed following the
+// immersed domain every <code>remesh_interval_f</code> time steps, if
+// positive.
+
+  unsigned int adaptive_cycles_f;
+
+  unsigned int buffer_layers_f;
+
+  double kelly_fraction_f;
+
+  unsigned int remesh_interval_f;
+
+
 // Maps of boundary value functions: 1st: a boundary indicator;
 // 2nd: a boundary value function.
 
@@ -152,6 +178,7 @@ public:
 
 // Map storing the boundary conditions: 1st: a boundary degree of freedom;
 // 2nd: the value of field corresponding to the given degree of freedom.
+// The values used by IFEM are kept in <code>IFEM::dense_boundary_values</code>.
 
   map<unsigned int, double> boundary_values;
 
@@ -173,6 +200,12 @@ public:
 
   bool fix_pressure;
 
+// When set to true, the zero average of the pressure is not imposed
+// through a dense row of the Jacobian, but by projecting the pressure
+// after each update.
+
+  bool project_pressure;
+
 
 // Flag to indicate whether homogeneous Dirichlet boundary conditions
 // are applied.
@@ -180,12 +213,76 @@ public:
   bool all_DBC;
 
 
+// Whether the user declared the Dirichlet data of the control volume to
+// be the product of a function of time and a function of space, so that
+// only the time factor needs to be evaluated at each time step.
+
+  bool separable_bc;
+
+
 // When set to true, an update of the system Jacobian is
 // performed at the beginning of each time step.
 
   bool update_jacobian_at_step_beginning;
 
 
+// Policy deciding when the Newton loop refreshes the Jacobian (see
+// <code>NewtonPolicy</code>), and its tolerances. The tolerances are
+// only used by the contraction-rate policy; the legacy one keeps its
+// fixed absolute tolerance.
+
+  bool adaptive_jacobian_refresh;
+
+  double newton_absolute_tolerance;
+
+  double newton_relative_tolerance;
+
+  double jacobian_refresh_contraction;
+
+  unsigned int max_newton_iterations;
+
+
+// When set to true, the Newton updates are computed with GMRES,
+// preconditioned by the last factorization of the Jacobian, to the
+// relative accuracy given by a constant or an Eisenstat-Walker forcing
+// term (see <code>ForcingTerm</code>).
+
+  bool iterative_linear_solver;
+
+// When set to true, the Jacobian is never assembled: GMRES is applied
+// to a finite-difference approximation of its action, preconditioned
+// by the factorization of the fluid block alone.
+
+  bool jacobian_free;
+
+// When set to true, the operator of GMRES is the finite-difference
+// approximation of the action of the Jacobian instead of the assembled
+// Jacobian, which is then only assembled to be factorized.
+
+  bool finite_difference_operator;
+
+// Backend of the factorizations of the Jacobian and of the mass matrix
+// of the immersed domain (see <code>create_direct_solver()</code>).
+
+  string direct_solver;
+
+// Renumbering of the dofs of both domains (see
+// <code>renumber_dofs()</code>), and ordering of the columns of the
+// Jacobian used by its factorization.
+
+  string dof_renumbering;
+
+  string factorization_ordering;
+
+  bool eisenstat_walker;
+
+  double initial_forcing_term;
+
+  double max_forcing_term;
+
+  unsigned int max_linear_iterations;
+
+
 // Name of the mesh file for the solid domain.
 
   string solid_mesh;
@@ -196,6 +293,12 @@ public:
   string fluid_mesh;
 
 
+// Directory of the cache of the refined meshes, numbering of the dofs
+// and sparsity patterns. The cache is not used if empty.
+
+  string setup_cache_directory;
+
+
 // Name of the output file.
 
   string output_name;
@@ -264,10 +367,25 @@ public:
 
   Point<dim> ring_center;
 
-// Variables to store the strength(s) and location(s) of point source(s)
+// Variables to store the strength(s) and location(s) of point source(s).
+// The strength of source i is pt_source_scale[i] times the value of
+// *pt_source_function[i], which is either one of the functions in
+// pt_source_strength, given for each of the sources listed in the
+// parameter file, or a function shared by all the sources read from the
+// point source file.
   unsigned int n_pt_source;
   vector<ParsedFunction<dim>*> pt_source_strength;
   vector<Point<dim> > pt_source_location;
+  vector<double> pt_source_scale;
+  vector<Function<dim>*> pt_source_function;
+
+  ParsedFunction<dim> pt_source_shared_strength;
+  TimeSeriesFunction<dim> pt_source_time_series;
+
+// Points at which the fields of the control volume and the displacement
+// of the immersed domain are written at every time step.
+  vector<Point<dim> > fluid_probe_points;
+  vector<Point<dim> > solid_probe_points;
 
 // Variable to store the constants necessary to impose the penalty due to
 // the compressibility of the solid
@@ -329,6 +447,35 @@ public:
 // Prefix of files required for restart.
   string file_info_for_restart;
 
+
+// Whether the fluid and solid blocks of the sparsity pattern of the
+// Jacobian are saved with the state, so that they are not computed
+// again on restart.
+  bool checkpoint_sparsity;
+
+
+// Checkpoints are written every <code>checkpoint_step_interval</code>
+// time steps and every <code>checkpoint_minutes</code> minutes of wall
+// clock time, a zero value disabling either criterion, and at the end
+// of the computation. Only the last <code>n_checkpoints_kept</code> are
+// kept, and they may be written by a background task.
+  unsigned int checkpoint_step_interval;
+
+  double checkpoint_minutes;
+
+  unsigned int n_checkpoints_kept;
+
+  bool background_checkpoints;
+
+
+// When not negative, the step from which the computation is restarted,
+// using the solution frames written at each step by a previous run with
+// the given base name (the output base name if empty), rather than a
+// checkpoint.
+  int restart_step;
+
+  string restart_frames_name;
+
 };
 
 #endif
@@ -0,0 +1,129 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef inexact_newton_h
+#define inexact_newton_h
+
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+
+using namespace dealii;
+using namespace std;
+
+//! Forcing terms of an inexact Newton method. When the Newton update
+//! $s_{k}$ is computed with an iterative solver, the linear system
+//! $J_{k} s_{k} = -F_{k}$ is only solved to the relative tolerance
+//! $\eta_{k}$, i.e., until $\|J_{k} s_{k} + F_{k}\| \le \eta_{k}
+//! \|F_{k}\|$. With the <code>eisenstat_walker</code> choice,
+//! $\eta_{k} = \gamma (\|F_{k}\|/\|F_{k-1}\|)^{\alpha}$, with
+//! $\gamma = 0.9$ and $\alpha = 2$ (choice 2 of Eisenstat and Walker,
+//! SIAM J. Sci. Comput. 17, 1996), so that the linear systems are
+//! solved loosely far from the solution and more and more accurately as
+//! the iteration converges. The usual safeguards are applied: $\eta_{k}$
+//! does not decrease abruptly, does not exceed a maximum value, and is
+//! not smaller than needed to reach the Newton tolerance.
+class ForcingTerm
+{
+public:
+
+  enum Type
+  {
+    constant,
+    eisenstat_walker
+  };
+
+  ForcingTerm ();
+
+//! The value <code>eta_0</code> is used for the first iteration of each
+//! step, and for all of them with the <code>constant</code> choice.
+
+  void initialize (const Type type,
+                   const double eta_0,
+                   const double eta_max,
+                   const double newton_tolerance);
+
+//! Reset the counters at the beginning of a time step.
+
+  void begin_step ();
+
+//! Forcing term for the update computed from a residual of norm
+//! <code>res_norm</code>.
+
+  double value (const double res_norm);
+
+//! Record the number of iterations of a linear solve.
+
+  void linear_solve_done (const unsigned int n_iterations);
+
+//! Number of linear solves and of linear iterations in the current step
+//! and in all the steps.
+
+  unsigned int n_linear_solves;
+
+  unsigned int n_linear_iterations;
+
+  unsigned int n_total_linear_solves;
+
+  unsigned int n_total_linear_iterations;
+
+private:
+
+  Type type;
+
+  double eta_0;
+
+  double eta_max;
+
+  double newton_tolerance;
+
+  double previous_norm;
+
+  double previous_eta;
+};
+
+
+// Solve $A x = b$ with GMRES, right preconditioned by <code>P</code>, until
+// the norm of the residual is smaller than <code>tolerance</code>. The
+// initial guess is zero. Returns the number of iterations; if these
+// were not enough to reach the tolerance, <code>converged</code> is set to
+// false and <code>x</code> is the last iterate.
+
+template <class MatrixType, class PreconditionerType, class VectorType>
+unsigned int
+solve_gmres (const MatrixType &A,
+             const PreconditionerType &P,
+             const VectorType &b,
+             VectorType &x,
+             const double tolerance,
+             const unsigned int max_iterations,
+             bool &converged)
+{
+  SolverControl control (max_iterations, tolerance, false, false);
+  typename SolverGMRES<VectorType>::AdditionalData data (50, true);
+  SolverGMRES<VectorType> gmres (control, data);
+
+  x = 0;
+  converged = true;
+  try
+    {
+      gmres.solve (A, x, b, P);
+    }
+  catch (SolverControl::NoConvergence &)
+    {
+      converged = false;
+    }
+  return control.last_step();
+}
+
+#endif
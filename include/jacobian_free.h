@@ -0,0 +1,138 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef jacobian_free_h
+#define jacobian_free_h
+
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/lac/block_vector.h>
+
+#include "direct_solver.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace dealii;
+using namespace std;
+
+//! Action of the Jacobian of the residual on a vector, approximated by
+//! a finite difference of two residuals,
+//! \f[
+//!   J(\xi) v \approx \frac{F(\xi + h v) - F(\xi)}{h},
+//! \f]
+//! with $h = \sqrt{\epsilon} (1 + \|\xi\|)/\|v\|$, $\epsilon$ being
+//! the machine precision. Used as the operator of a Krylov solver, it
+//! gives a Newton method in which the Jacobian is never assembled.
+//!
+//! The <code>Problem</code> class must provide a function
+//! <code>evaluate_residual (xi, t, residual)</code>, computing the
+//! residual at the state <code>xi</code> and time <code>t</code>.
+template <class Problem>
+class FiniteDifferenceJacobian : public Subscriptor
+{
+public:
+
+  FiniteDifferenceJacobian (Problem &p)
+    :
+    n_residuals (0),
+    problem (&p),
+    t (0.0),
+    xi_norm (0.0)
+  {};
+
+//! Set the state at which the Jacobian is evaluated, along with the
+//! residual at that state.
+
+  void reinit (const BlockVector<double> &xi,
+               const BlockVector<double> &residual,
+               const double time)
+  {
+    base_xi = xi;
+    base_residual = residual;
+    perturbed_xi.reinit (xi);
+    t = time;
+    xi_norm = xi.l2_norm();
+  };
+
+  void vmult (BlockVector<double> &dst,
+              const BlockVector<double> &src) const
+  {
+    const double src_norm = src.l2_norm();
+    if (src_norm == 0)
+      {
+        dst = 0;
+        return;
+      }
+
+    const double h = std::sqrt (std::numeric_limits<double>::epsilon())
+                     * (1.0 + xi_norm) / src_norm;
+
+    perturbed_xi = base_xi;
+    perturbed_xi.add (h, src);
+    problem->evaluate_residual (perturbed_xi, t, dst);
+    ++n_residuals;
+
+    dst -= base_residual;
+    dst /= h;
+  };
+
+//! Number of residual evaluations done by <code>vmult</code>.
+
+  mutable unsigned int n_residuals;
+
+private:
+
+  Problem *problem;
+
+  double t;
+
+  double xi_norm;
+
+  BlockVector<double> base_xi;
+
+  BlockVector<double> base_residual;
+
+  mutable BlockVector<double> perturbed_xi;
+};
+
+
+//! Block diagonal preconditioner for the system in the velocity and
+//! pressure of the control volume and in the displacement of the
+//! immersed domain. The first block is inverted with a factorization of
+//! (an approximation of) the fluid block of the Jacobian, the second one
+//! with a factorization of the mass matrix of the immersed domain,
+//! multiplied by <code>solid_factor</code>.
+class BlockDiagonalPreconditioner : public Subscriptor
+{
+public:
+
+  void initialize (const DirectSolver &fluid_inverse,
+                   const DirectSolver &solid_inverse,
+                   const double solid_factor);
+
+  void vmult (BlockVector<double> &dst,
+              const BlockVector<double> &src) const;
+
+private:
+
+  SmartPointer<const DirectSolver, BlockDiagonalPreconditioner> fluid_inverse;
+
+  SmartPointer<const DirectSolver, BlockDiagonalPreconditioner> solid_inverse;
+
+  double solid_factor;
+};
+
+#endif
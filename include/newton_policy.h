@@ -0,0 +1,192 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef newton_policy_h
+#define newton_policy_h
+
+#include <deal.II/base/exceptions.h>
+
+using namespace dealii;
+using namespace std;
+
+//! Decisions of the Newton loop of <code>IFEM::run</code>: when the
+//! iteration has converged and when the Jacobian must be assembled and
+//! factorized again, rather than reused from a previous iteration or
+//! time step.
+//!
+//! Two policies are available. The <code>legacy</code> one is the original
+//! heuristic: the Jacobian is refreshed after any update computed from
+//! a residual larger than $10^{-2}$, after every 10 iterations, and at
+//! the beginning of each step if so requested. The <code>contraction</code>
+//! policy monitors the ratio $\|r_{k}\|/\|r_{k-1}\|$ of successive
+//! residual norms and refreshes the Jacobian only when this ratio
+//! exceeds a given threshold, i.e., when the stale Jacobian no longer
+//! yields a fast enough convergence. It also accepts a tolerance
+//! relative to the first residual of the step.
+class NewtonPolicy
+{
+public:
+
+  enum Type
+  {
+    legacy,
+    contraction
+  };
+
+  NewtonPolicy ();
+
+//! Convergence is declared when the norm of the residual is smaller
+//! than the larger of <code>absolute_tolerance</code> and
+//! <code>relative_tolerance</code> times the first residual of the step.
+//! The two flags have the meaning of the corresponding parameters of
+//! the original scheme, and apply to both policies.
+
+  void initialize (const Type type,
+                   const double absolute_tolerance,
+                   const double relative_tolerance,
+                   const double contraction_threshold,
+                   const unsigned int max_iterations,
+                   const bool refresh_continuously,
+                   const bool refresh_at_step_beginning);
+
+//! Reset the counters at the beginning of a time step.
+
+  void begin_step ();
+
+//! Whether the Jacobian must be assembled and factorized before the
+//! next update is computed.
+
+  bool refresh_requested () const
+  {
+    return refresh;
+  };
+
+//! Request a refresh before the next update, e.g., because the
+//! factorization failed to provide an accurate enough update.
+
+  void request_refresh ()
+  {
+    refresh = true;
+  };
+
+//! Record that the last factorization can no longer be used, because
+//! the dofs changed. The Jacobian is refreshed before the next update,
+//! also at the beginning of the next step.
+
+  void discard_jacobian ()
+  {
+    has_jacobian = false;
+    jacobian_is_current = false;
+    refresh = true;
+  };
+
+//! Whether the last factorization was computed at the current iterate.
+
+  bool jacobian_current () const
+  {
+    return jacobian_is_current;
+  };
+
+//! Record that the Jacobian was assembled and factorized at the current
+//! iterate, or that the previous factorization is used.
+
+  void jacobian_refreshed ();
+
+  void jacobian_reused ();
+
+//! Record the norm of the residual at the current iterate, and return
+//! whether the iteration has converged. With the <code>contraction</code>
+//! policy, a refresh is requested if the residual did not decrease
+//! enough since the previous iterate.
+
+  bool converged (const double res_norm);
+
+//! Record that an update was computed from the residual of norm
+//! <code>res_norm</code>. An exception is thrown if the maximum number of
+//! iterations has been exceeded.
+
+  void update_computed (const double res_norm);
+
+//! Number of updates computed in the current step.
+
+  unsigned int n_iterations;
+
+//! Number of factorizations, and of updates computed with a
+//! factorization from an earlier iterate, in the current step.
+
+  unsigned int n_refreshes;
+
+  unsigned int n_reuses;
+
+//! Same numbers, accumulated over all the steps.
+
+  unsigned int n_total_iterations;
+
+  unsigned int n_total_refreshes;
+
+  unsigned int n_total_reuses;
+
+//! Ratio of the last two residual norms of the step, or zero if fewer
+//! than two residuals were computed.
+
+  double contraction_ratio;
+
+//! Write or read the counters accumulated over the steps, which are
+//! part of a checkpoint. The state of the current step is not: a
+//! computation restarts at the beginning of a step, with no
+//! factorization of the Jacobian.
+
+  template <class Archive>
+  void serialize (Archive &ar, const unsigned int)
+  {
+    ar &n_total_iterations;
+    ar &n_total_refreshes;
+    ar &n_total_reuses;
+  };
+
+private:
+
+  Type type;
+
+  double absolute_tolerance;
+
+  double relative_tolerance;
+
+  double contraction_threshold;
+
+  unsigned int max_iterations;
+
+  bool refresh_continuously;
+
+  bool refresh_at_step_beginning;
+
+  bool refresh;
+
+  bool has_jacobian;
+
+// Whether the Jacobian was factorized at the current iterate.
+  bool jacobian_is_current;
+
+  double first_norm;
+
+  double previous_norm;
+
+// Counters of the legacy policy: iterations since the last forced
+// refresh and number of forced refreshes.
+  unsigned int cycle_iterations;
+
+  unsigned int n_cycles;
+};
+
+#endif
@@ -0,0 +1,101 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef point_probe_h
+#define point_probe_h
+
+#include <deal.II/base/point.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <utility>
+#include <vector>
+
+#include "cartesian_grid_locator.h"
+
+using namespace dealii;
+using namespace std;
+
+//! Evaluation of a finite element field at a point that does not move
+//! with respect to the triangulation. The cell containing the point and
+//! the values of the shape functions of that cell at the point are
+//! found once by <code>initialize()</code>; afterwards, the value of the
+//! field is a weighted sum of the dof values, with no search in the
+//! triangulation. This is what <code>VectorTools::point_value</code>
+//! computes, at a fraction of the cost. The finite element must be
+//! primitive.
+template <int dim>
+class PointProbe
+{
+public:
+
+  PointProbe ();
+
+//! Locate <code>point</code> in the triangulation of <code>dh</code>,
+//! described by <code>mapping</code>, or by <code>grid</code> if it is
+//! given and the triangulation is a uniform Cartesian grid. An exception
+//! is thrown if the point is outside of the triangulation.
+
+  void initialize (const Mapping<dim> &mapping,
+                   const DoFHandler<dim> &dh,
+                   const Point<dim> &point,
+                   const CartesianGridLocator<dim> *grid = 0);
+
+//! All the components of the field at the point. <code>values</code>
+//! must have as many entries as the finite element has components.
+
+  void value (const Vector<double> &x,
+              Vector<double> &values) const;
+
+//! A single component of the field at the point.
+
+  double value (const Vector<double> &x,
+                const unsigned int component) const;
+
+//! The dofs of the cell containing the point whose shape functions
+//! belong to the given component, each with the value of its shape
+//! function at the point.
+
+  vector< pair<unsigned int, double> > component_weights (const unsigned int component) const;
+
+  bool is_initialized () const
+  {
+    return !dofs.empty();
+  };
+
+//! The point, its cell, and its coordinates in the reference cell.
+
+  Point<dim> point;
+
+  typename DoFHandler<dim>::active_cell_iterator cell;
+
+  Point<dim> unit_point;
+
+private:
+
+  unsigned int n_components;
+
+  vector<unsigned int> dofs;
+
+  vector<unsigned int> components;
+
+  vector<double> weights;
+};
+
+#endif
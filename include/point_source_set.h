@@ -0,0 +1,172 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef point_source_set_h
+#define point_source_set_h
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/function.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! A scalar function of time only, given by a table of (time, value)
+//! pairs and interpolated linearly. Outside of the table the first or
+//! the last value is used.
+template <int dim>
+class TimeSeriesFunction : public Function<dim>
+{
+public:
+
+  TimeSeriesFunction ();
+
+//! Read the table from a file with two columns, time and value. Empty
+//! lines and lines starting with <code>#</code> are skipped. The times
+//! must be increasing.
+
+  void read (const string &filename);
+
+  virtual double value (const Point<dim> &p,
+                        const unsigned int component = 0) const;
+
+  virtual void value_list (const vector< Point<dim> > &points,
+                           vector<double> &values,
+                           const unsigned int component = 0) const;
+
+  bool empty () const
+  {
+    return times.empty();
+  };
+
+private:
+
+  double current_value () const;
+
+  vector<double> times;
+
+  vector<double> values;
+};
+
+
+//! Read a list of point sources from a file. Each line contains the
+//! coordinates of a source followed, optionally, by a factor multiplying
+//! its strength (one by default). Empty lines and lines starting with
+//! <code>#</code> are skipped; any other content throws an exception.
+
+template <int dim>
+void read_point_sources (const string &filename,
+                         vector< Point<dim> > &locations,
+                         vector<double> &scales);
+
+
+//! A set of point sources of the mass balance. The strength of source
+//! $i$ is $s_i f_i(\mathbf{x}_i, t)$, where $s_i$ is a scale factor and
+//! the function $f_i$ may be shared by any number of sources. The
+//! sources do not move: <code>initialize()</code> locates each of them
+//! once and keeps the nonzero entries of its point source vector. The
+//! strengths are evaluated once per time, with one call to
+//! <code>value_list()</code> for each distinct function, and the vector
+//! of all the sources is assembled in a single pass over those entries.
+template <int dim>
+class PointSourceSet
+{
+public:
+
+  PointSourceSet ();
+
+  void clear ();
+
+//! Add a source. The function must stay alive as long as this object.
+
+  void add (const Point<dim> &location,
+            Function<dim> &strength,
+            const double scale = 1.0);
+
+//! Locate the sources in the triangulation of <code>dh</code> and keep
+//! the values at the sources of the shape functions of the given
+//! component.
+
+  void initialize (const Mapping<dim> &mapping,
+                   const DoFHandler<dim> &dh,
+                   const unsigned int component);
+
+//! Strengths of all the sources at time <code>t</code>. They are only
+//! recomputed if the time changed since the last call.
+
+  const vector<double> &get_strengths (const double t);
+
+//! Store in <code>v</code> the point source vector of all the sources
+//! at time <code>t</code>, multiplied by <code>factor</code>. Only the
+//! entries listed in <code>dofs()</code> are written.
+
+  void assemble (const double t,
+                 const double factor,
+                 Vector<double> &v);
+
+//! The entries of the point source vector that can be nonzero, each
+//! listed once.
+
+  const vector<unsigned int> &dofs () const
+  {
+    return touched_dofs;
+  };
+
+  unsigned int n_sources () const
+  {
+    return locations.size();
+  };
+
+private:
+
+  vector< Point<dim> > locations;
+
+  vector<double> scales;
+
+// The distinct strength functions, and for each of them the sources
+// using it and their locations.
+  vector<Function<dim> *> functions;
+
+  vector< vector<unsigned int> > function_sources;
+
+  vector< vector< Point<dim> > > function_locations;
+
+  vector<double> function_values;
+
+  vector<double> strengths;
+
+  double strength_time;
+
+  bool has_strengths;
+
+// Nonzero entries of the point source vectors of all the sources:
+// source, dof and weight of each entry.
+  vector<unsigned int> entry_sources;
+
+  vector<unsigned int> entry_dofs;
+
+  vector<double> entry_weights;
+
+  vector<unsigned int> touched_dofs;
+};
+
+#endif
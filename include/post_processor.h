@@ -75,6 +75,12 @@
 // Our own include files
 #include "ifem_parameters.h"
 #include "exact_solution_ring_with_fibers.h"
+#include "geometry_cache.h"
+#include "point_probe.h"
+#include "support_point_index.h"
+#include "dof_ordering.h"
+#include "setup_cache.h"
+#include "fluid_refinement.h"
 
 using namespace std;
 
@@ -256,6 +262,19 @@ private:
   double area;
 
 
+  // Diameters, measure and boundary faces of the fluid triangulation.
+  GeometryCache<dim> fluid_geometry;
+
+  // Triangulations and numbering of the dofs saved by a previous run
+  // with the same setup.
+  SetupCache<dim> setup_cache;
+
+
+  // Support points of the dofs of the immersed domain, used to find the
+  // dofs located at given points.
+  SupportPointIndex<dim> solid_support_points;
+
+
   // File stream that is used to output a file containing information
   // about the fluid flux, area and the centroid of the immersed domain
   // over time.
@@ -266,6 +285,14 @@ private:
   ofstream fsi_bm_out_file;
 
 
+  // Points A (in the reference configuration of the flag) and B (in the
+  // control volume) of the benchmark, located the first time they are
+  // needed.
+  PointProbe<dim> probe_A;
+
+  PointProbe<dim> probe_B;
+
+
   //Variable to store the current_time;
   double current_time;
 
@@ -0,0 +1,146 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef setup_cache_h
+#define setup_cache_h
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Final index of each dof of <code>dh</code>, in the order in which
+//! <code>distribute_dofs</code> numbers them on the same triangulation.
+//! Passing it to <code>DoFHandler::renumber_dofs</code>, right after the
+//! dofs are distributed again, restores the numbering of <code>dh</code>.
+
+template <int dim>
+void final_dof_numbering (const DoFHandler<dim> &dh,
+                          vector<types::global_dof_index> &numbering);
+
+//! Cache of the setup of a computation on disk: the refined
+//! triangulations of the control volume and of the immersed domain, the
+//! numbering of their dofs, and optionally the sparsity patterns of the
+//! fluid and solid blocks, which only depend on these. The cache is a
+//! file in a given directory, whose name is derived from a key
+//! describing everything the setup depends on: the content of the mesh
+//! files, the refinements, the finite elements, the renumbering, and
+//! whatever else the caller adds to it.
+//!
+//! The triangulations are restored with their boundary and manifold
+//! indicators, but the manifold objects must be attached again. The
+//! numbering of the dofs is restored by distributing the dofs as usual
+//! and then calling <code>renumber_dofs()</code>, which is much faster than
+//! the renumbering algorithms.
+template <int dim>
+class SetupCache
+{
+public:
+
+  SetupCache ();
+
+//! Set the directory of the cache, which disables it if empty, and the
+//! key. The content of the files in <code>files</code> is part of the key.
+
+  void initialize (const string &directory,
+                   const string &description,
+                   const vector<string> &files);
+
+  bool enabled () const
+  {
+    return !filename.empty();
+  };
+
+//! Restore the triangulations from the cache, if it holds the setup of
+//! this key, and return whether it did.
+
+  bool load (Triangulation<dim> &tria_f,
+             Triangulation<dim> &tria_s);
+
+//! Whether the setup was restored by <code>load()</code>.
+
+  bool loaded () const
+  {
+    return is_loaded;
+  };
+
+//! Give the dofs of <code>dh_f</code> and <code>dh_s</code>, just distributed
+//! on the restored triangulations, the numbering they had when the cache
+//! was saved.
+
+  void renumber_dofs (DoFHandler<dim> &dh_f,
+                      DoFHandler<dim> &dh_s) const;
+
+//! Whether the cache holds the sparsity patterns, and the patterns
+//! themselves.
+
+  bool has_sparsity () const
+  {
+    return with_sparsity;
+  };
+
+  const SparsityPattern &fluid_sparsity () const
+  {
+    return sparsity_f;
+  };
+
+  const SparsityPattern &solid_sparsity () const
+  {
+    return sparsity_s;
+  };
+
+//! Release the memory taken by the sparsity patterns, once copied.
+
+  void clear_sparsity ();
+
+//! Save the setup. The triangulations must be the ones the dof
+//! handlers are built on, unchanged since they were refined; the
+//! sparsity patterns are only saved if both are given.
+
+  void save (const Triangulation<dim> &tria_f,
+             const Triangulation<dim> &tria_s,
+             const DoFHandler<dim> &dh_f,
+             const DoFHandler<dim> &dh_s,
+             const SparsityPattern *fluid_pattern = 0,
+             const SparsityPattern *solid_pattern = 0);
+
+private:
+
+  string cache_directory;
+
+  string filename;
+
+  string key;
+
+  bool is_loaded;
+
+  bool with_sparsity;
+
+// For each domain, the final index of each dof, in the order in which
+// <code>distribute_dofs</code> numbers them.
+  vector<types::global_dof_index> numbering_f;
+
+  vector<types::global_dof_index> numbering_s;
+
+  SparsityPattern sparsity_f;
+
+  SparsityPattern sparsity_s;
+};
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef support_point_index_h
+#define support_point_index_h
+
+#include <deal.II/base/point.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <vector>
+
+using namespace dealii;
+using namespace std;
+
+//! Spatial index of the support points of the dofs of a
+//! <code>DoFHandler</code>. The support points are computed once by
+//! <code>initialize()</code> and stored in a k-d tree, so that finding
+//! the dofs located at, or near, a point costs a logarithmic number of
+//! operations instead of a scan of all the dofs. The tree is implicit:
+//! it is a permutation of the dof indices such that, for every range of
+//! the permutation, the median entry splits the others along one
+//! coordinate direction.
+template <int dim>
+class SupportPointIndex
+{
+public:
+
+  SupportPointIndex ();
+
+  void initialize (const Mapping<dim> &mapping,
+                   const DoFHandler<dim> &dh);
+
+//! The dof whose support point is closest to each of the given points.
+//! When several dofs share a support point, any of them may be returned.
+
+  vector<unsigned int> nearest (const vector< Point<dim> > &points) const;
+
+//! The dofs whose support points are within distance <code>radius</code>
+//! of each of the given points, sorted by dof index.
+
+  vector< vector<unsigned int> > within_radius (const vector< Point<dim> > &points,
+                                                const double radius) const;
+
+  const Point<dim> &support_point (const unsigned int dof) const
+  {
+    return support_points[dof];
+  };
+
+  unsigned int size () const
+  {
+    return support_points.size();
+  };
+
+private:
+
+  void build (const unsigned int begin,
+              const unsigned int end,
+              const unsigned int depth);
+
+  void find_nearest (const Point<dim> &p,
+                     const unsigned int begin,
+                     const unsigned int end,
+                     const unsigned int depth,
+                     unsigned int &best,
+                     double &best_distance_square) const;
+
+  void find_within_radius (const Point<dim> &p,
+                           const double radius,
+                           const unsigned int begin,
+                           const unsigned int end,
+                           const unsigned int depth,
+                           vector<unsigned int> &dofs) const;
+
+  vector< Point<dim> > support_points;
+
+  vector<unsigned int> tree;
+};
+
+#endif
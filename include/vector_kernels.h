@@ -0,0 +1,35 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#ifndef vector_kernels_h
+#define vector_kernels_h
+
+#include <deal.II/lac/block_vector.h>
+
+using namespace dealii;
+using namespace std;
+
+//! Time derivative of the state given by the implicit Euler method,
+//! \f[
+//!   \xi' = \frac{\xi - \xi_{\rm previous}}{dt},
+//! \f]
+//! computed in a single pass over the three vectors, rather than with
+//! a copy, a subtraction and a scaling.
+
+void time_derivative (const BlockVector<double> &xi,
+                      const BlockVector<double> &previous_xi,
+                      const double dt,
+                      BlockVector<double> &xit);
+
+#endif
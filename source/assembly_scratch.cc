@@ -0,0 +1,442 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "assembly_scratch.h"
+#include <deal.II/base/std_cxx14/memory.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+
+template <int dim>
+PointShapeValues<dim>::PointShapeValues ()
+  :
+  n_quadrature_points (0),
+  compute_hessians (false)
+{}
+
+
+template <int dim>
+void
+PointShapeValues<dim>::initialize (const FiniteElement<dim> &finite_element,
+                                   const unsigned int max_points,
+                                   const bool with_hessians)
+{
+  fe = &finite_element;
+  compute_hessians = with_hessians;
+  n_quadrature_points = 0;
+
+  values.reinit (fe->dofs_per_cell, max_points);
+  gradients.reinit (fe->dofs_per_cell, max_points);
+  if (compute_hessians)
+    hessians.reinit (fe->dofs_per_cell, max_points);
+  else
+    hessians.reinit (0, 0);
+}
+
+
+// The shape functions are evaluated on the reference cell and then
+// transformed with the d-linear mapping of the cell. This is exactly
+// what <code>FEValues</code> does with the default mapping, but without
+// building a new quadrature formula for every set of points.
+//
+// Denoting by $K$ the inverse of the Jacobian of the mapping, the
+// gradients are $K^{T} \hat{\nabla} \hat{\phi}$, while the hessians are
+// $K^{T} (\hat{\nabla}^{2} \hat{\phi} - \sum_{k} \partial_{x_{k}} \phi\,
+// \hat{\nabla}^{2} x_{k}) K$.
+
+template <int dim>
+void
+PointShapeValues<dim>::reinit (
+  const typename DoFHandler<dim>::active_cell_iterator &cell,
+  const vector< Point<dim> > &unit_points)
+{
+  Assert (fe != 0, ExcNotInitialized());
+
+  n_quadrature_points = unit_points.size();
+
+// This happens only if more points than the ones announced to
+// <code>initialize()</code> are requested.
+  if (n_quadrature_points > values.n_cols())
+    {
+      values.reinit (fe->dofs_per_cell, n_quadrature_points);
+      gradients.reinit (fe->dofs_per_cell, n_quadrature_points);
+      if (compute_hessians)
+        hessians.reinit (fe->dofs_per_cell, n_quadrature_points);
+    }
+
+  for (unsigned int q=0; q<n_quadrature_points; ++q)
+    {
+      const Point<dim> &p = unit_points[q];
+
+      Tensor<2,dim> jacobian;
+      Tensor<3,dim> mapping_hessian;
+
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          const Point<dim> &x_v = cell->vertex(v);
+          const Tensor<1,dim> grad_v
+            = GeometryInfo<dim>::d_linear_shape_function_gradient (p, v);
+
+          for (unsigned int k=0; k<dim; ++k)
+            for (unsigned int a=0; a<dim; ++a)
+              jacobian[k][a] += x_v[k] * grad_v[a];
+
+// The d-linear shape functions have vanishing second derivatives with
+// respect to a single coordinate, so only the mixed ones are computed.
+          if (compute_hessians)
+            for (unsigned int a=0; a<dim; ++a)
+              for (unsigned int b=a+1; b<dim; ++b)
+                {
+                  double d2 = 1.0;
+                  for (unsigned int e=0; e<dim; ++e)
+                    {
+                      const bool upper = (GeometryInfo<dim>::unit_cell_vertex(v)[e] > 0.5);
+                      if (e == a || e == b)
+                        d2 *= (upper ? 1.0 : -1.0);
+                      else
+                        d2 *= (upper ? p[e] : 1.0 - p[e]);
+                    }
+                  for (unsigned int k=0; k<dim; ++k)
+                    {
+                      mapping_hessian[k][a][b] += x_v[k] * d2;
+                      mapping_hessian[k][b][a] += x_v[k] * d2;
+                    }
+                }
+        }
+
+      const Tensor<2,dim> inverse_jacobian = invert (jacobian);
+
+      for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+        {
+          values(i,q) = fe->shape_value (i, p);
+          gradients(i,q) = fe->shape_grad (i, p) * inverse_jacobian;
+
+          if (compute_hessians)
+            {
+              Tensor<2,dim> unit_hessian = fe->shape_grad_grad (i, p);
+              for (unsigned int k=0; k<dim; ++k)
+                unit_hessian -= gradients(i,q)[k] * mapping_hessian[k];
+
+              hessians(i,q) = transpose (inverse_jacobian)
+                              * unit_hessian
+                              * inverse_jacobian;
+            }
+        }
+    }
+}
+
+
+template <int dim>
+AssemblyScratch<dim>::AssemblyScratch ()
+  :
+  initialized (false)
+{}
+
+
+template <int dim>
+void
+AssemblyScratch<dim>::reinit (const FiniteElement<dim> &fe_f,
+                              const FiniteElement<dim, dim> &fe_s,
+                              const Quadrature<dim> &quad_f,
+                              const Quadrature<dim> &quad_s,
+                              const Mapping<dim, dim> &immersed_mapping,
+                              const bool hessians)
+{
+  const unsigned int n_local_dofs = fe_f.dofs_per_cell + fe_s.dofs_per_cell;
+
+  const unsigned int nqpf = quad_f.size();
+  const unsigned int nqps = quad_s.size();
+  const unsigned int nqp  = std::max (nqpf, nqps);
+
+  fe_f_v = std_cxx14::make_unique<FEValues<dim> > (fe_f,
+                                                   quad_f,
+                                                   update_values |
+                                                   update_gradients |
+                                                   update_JxW_values |
+                                                   update_quadrature_points);
+
+  fe_v_s = std_cxx14::make_unique<FEValues<dim, dim> > (fe_s,
+                                                        quad_s,
+                                                        update_quadrature_points |
+                                                        update_values |
+                                                        update_gradients |
+                                                        update_JxW_values);
+
+  fe_v_s_mapped = std_cxx14::make_unique<FEValues<dim, dim> > (immersed_mapping,
+                                                               fe_s,
+                                                               quad_s,
+                                                               update_quadrature_points);
+
+// The quadrature points of a solid cell falling in a single fluid cell
+// cannot be more than the quadrature points of the solid cell.
+  local_fe_f_v.initialize (fe_f, nqps, hessians);
+
+  dofs_f.resize (fe_f.dofs_per_cell);
+  dofs_s.resize (fe_s.dofs_per_cell);
+
+  local_res.resize (n_local_dofs);
+  local_pressure_coefficient.resize (n_local_dofs);
+  local_jacobian.reinit (n_local_dofs, n_local_dofs);
+  no_jacobian.reinit (0, 0);
+
+  local_force_f.assign (nqpf, Vector<double>(dim+1));
+  local_force_s.assign (nqps, Vector<double>(dim+1));
+
+  local_upt.assign (nqp, Vector<double>(dim+1));
+  local_up.assign (nqp, Vector<double>(dim+1));
+  local_grad_up.assign (nqp, vector< Tensor<1,dim> >(dim+1));
+  local_grad_upt.assign (nqp, vector< Tensor<1,dim> >(dim+1));
+  if (hessians)
+    local_hessian_up.assign (nqp, vector< Tensor<2,dim> >(dim+1));
+  else
+    local_hessian_up.clear ();
+  local_div_u.assign (nqp, 0.0);
+
+  local_Wt.assign (nqps, Vector<double>(dim));
+  local_W.assign (nqps, Vector<double>(dim));
+  H.assign (nqps, vector< Tensor<1,dim> >(dim));
+  Pe.assign (nqps, Tensor<2,dim,double>());
+  F.assign (nqps, Tensor<2,dim,double>());
+  P.assign (nqps, Tensor<2,dim,double>());
+  local_invFT.assign (nqps, Tensor<2,dim,double>());
+  local_J.assign (nqps, 0.0);
+  DPeFT_dxi.assign (nqps, vector< Tensor<2,dim,double> >
+                    (fe_s.dofs_per_cell, Tensor<2,dim,double>()));
+
+  local_A_gamma.reinit (fe_s.dofs_per_cell);
+  local_M_gamma3_inv_A_gamma.reinit (fe_s.dofs_per_cell);
+
+  initialized = true;
+}
+
+
+template <int dim>
+CouplingCache<dim>::CouplingCache ()
+  :
+  n_updates (0),
+  valid (false)
+{}
+
+
+template <int dim>
+void
+CouplingCache<dim>::initialize (const DoFHandler<dim> &dh_f,
+                                const Vector<double> &up,
+                                const DoFHandler<dim, dim> &dh,
+                                const CartesianGridLocator<dim> *cartesian_grid)
+{
+  clear ();
+
+// The vector is never used: the field function is only needed to
+// locate points in the triangulation of the control volume.
+  locator = std_cxx14::make_unique<Functions::FEFieldFunction<dim, DoFHandler<dim>, Vector<double> > >
+            (dh_f, up);
+  dh_s = &dh;
+  grid = cartesian_grid;
+  point_ids.clear ();
+}
+
+
+template <int dim>
+bool
+CouplingCache<dim>::is_up_to_date (const Vector<double> &d) const
+{
+  return (valid
+          &&
+          (displacement.size() == d.size())
+          &&
+          (displacement == d));
+}
+
+
+// The distinct points are those whose coordinates, rounded to a small
+// fraction of the size of the cells of the immersed domain, are equal.
+// Copies of a shared point computed from different cells only differ by
+// round-off; two points rounded to different values are just located
+// twice. The distinct points are numbered in the order in which they are
+// first met.
+
+template <int dim>
+void
+CouplingCache<dim>::build_point_table (const vector< Point<dim> > &all_points,
+                                       const double tolerance)
+{
+  vector< pair< std::array<long long, dim>, unsigned int > > keys (all_points.size());
+  for (unsigned int g=0; g<all_points.size(); ++g)
+    {
+      for (unsigned int d=0; d<dim; ++d)
+        keys[g].first[d] = std::llround (all_points[g][d] / tolerance);
+      keys[g].second = g;
+    }
+  std::sort (keys.begin(), keys.end());
+
+// Each point is mapped to the first copy of its distinct point.
+  vector<unsigned int> first_copy (all_points.size());
+  for (unsigned int k=0; k<keys.size(); ++k)
+    first_copy[keys[k].second] = ((k > 0 && keys[k].first == keys[k-1].first)
+                                  ?
+                                  first_copy[keys[k-1].second]
+                                  :
+                                  keys[k].second);
+
+  vector<unsigned int> ids (all_points.size());
+  unsigned int n_unique = 0;
+  for (unsigned int g=0; g<all_points.size(); ++g)
+    ids[g] = (first_copy[g] == g ? n_unique++ : ids[first_copy[g]]);
+
+  unsigned int g = 0;
+  for (unsigned int c=0; c<point_ids.size(); ++c)
+    for (unsigned int q=0; q<point_ids[c].size(); ++q, ++g)
+      point_ids[c][q] = ids[g];
+
+  point_cell.resize (n_unique);
+  point_reference.resize (n_unique);
+}
+
+
+template <int dim>
+void
+CouplingCache<dim>::update (FEValues<dim, dim> &fe_v_s_mapped,
+                            const Vector<double> &d)
+{
+  Assert (locator, ExcNotInitialized());
+
+  const unsigned int n_cells = dh_s->get_triangulation().n_active_cells();
+  const unsigned int n_q_points = fe_v_s_mapped.n_quadrature_points;
+  fluid_cells.resize (n_cells);
+  fluid_qpoints.resize (n_cells);
+  fluid_maps.resize (n_cells);
+
+// Current position of the quadrature points of all the cells. The
+// table of the distinct points is built the first time.
+  typename DoFHandler<dim,dim>::active_cell_iterator
+  cell = dh_s->begin_active(),
+  endc = dh_s->end();
+
+  points.resize (n_cells*n_q_points);
+  double min_diameter = cell->diameter();
+  for (unsigned int g=0; cell != endc; ++cell)
+    {
+      fe_v_s_mapped.reinit (cell);
+      for (unsigned int q=0; q<n_q_points; ++q, ++g)
+        points[g] = fe_v_s_mapped.quadrature_point(q);
+      min_diameter = std::min (min_diameter, cell->diameter());
+    }
+
+  if (point_ids.empty())
+    {
+      point_ids.assign (n_cells, vector<unsigned int>(n_q_points));
+      build_point_table (points, 1e-8*min_diameter);
+    }
+
+// The cells of the immersed domain are visited in order, and the
+// points of each cell that were not located yet are searched together,
+// close to the points of the previous cell. The locations are then
+// given to the cell in the same form as the output of the search.
+  located.assign (point_cell.size(), false);
+
+  vector< Point<dim> > batch;
+  vector<unsigned int> batch_ids;
+  vector< typename DoFHandler<dim>::active_cell_iterator > batch_cells;
+  vector< vector< Point<dim> > > batch_qpoints;
+  vector< vector< unsigned int > > batch_maps;
+
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      batch.clear ();
+      batch_ids.clear ();
+      for (unsigned int q=0; q<n_q_points; ++q)
+        {
+          const unsigned int id = point_ids[c][q];
+          if (!located[id])
+            {
+              located[id] = true;
+              batch.push_back (points[c*n_q_points+q]);
+              batch_ids.push_back (id);
+            }
+        }
+
+      if (!batch.empty())
+        {
+          if (grid != 0 && grid->is_cartesian())
+            grid->compute_point_locations (batch,
+                                           batch_cells,
+                                           batch_qpoints,
+                                           batch_maps);
+          else
+            locator->compute_point_locations (batch,
+                                              batch_cells,
+                                              batch_qpoints,
+                                              batch_maps);
+
+          for (unsigned int k=0; k<batch_cells.size(); ++k)
+            for (unsigned int j=0; j<batch_maps[k].size(); ++j)
+              {
+                const unsigned int id = batch_ids[batch_maps[k][j]];
+                point_cell[id] = batch_cells[k];
+                point_reference[id] = batch_qpoints[k][j];
+              }
+        }
+
+      fluid_cells[c].clear ();
+      fluid_qpoints[c].clear ();
+      fluid_maps[c].clear ();
+      for (unsigned int q=0; q<n_q_points; ++q)
+        {
+          const unsigned int id = point_ids[c][q];
+          const unsigned int i = std::find (fluid_cells[c].begin(),
+                                            fluid_cells[c].end(),
+                                            point_cell[id])
+                                 - fluid_cells[c].begin();
+          if (i == fluid_cells[c].size())
+            {
+              fluid_cells[c].push_back (point_cell[id]);
+              fluid_qpoints[c].push_back (vector< Point<dim> >());
+              fluid_maps[c].push_back (vector<unsigned int>());
+            }
+          fluid_qpoints[c][i].push_back (point_reference[id]);
+          fluid_maps[c][i].push_back (q);
+        }
+    }
+
+  displacement = d;
+  valid = true;
+  ++n_updates;
+}
+
+
+template <int dim>
+void
+CouplingCache<dim>::clear ()
+{
+  valid = false;
+  displacement.reinit (0);
+  fluid_cells.clear ();
+  fluid_qpoints.clear ();
+  fluid_maps.clear ();
+}
+
+
+template class PointShapeValues<2>;
+template class PointShapeValues<3>;
+
+template struct AssemblyScratch<2>;
+template struct AssemblyScratch<3>;
+
+template class CouplingCache<2>;
+template class CouplingCache<3>;
@@ -0,0 +1,278 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "boundary_data_cache.h"
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <iostream>
+#include <memory>
+#include <cmath>
+
+
+namespace
+{
+// Relative tolerance used to decide whether two sets of boundary data
+// are proportional.
+  const double separability_tolerance = 1e-10;
+
+// A function returning, for every component, either one coordinate of
+// the point or the index of the component. Interpolating it on the
+// boundary gives the support point and the component of each boundary
+// dof.
+  template <int dim>
+  class SupportPointFunction : public Function<dim>
+  {
+  public:
+    SupportPointFunction (const unsigned int n_components,
+                          const unsigned int coordinate)
+      :
+      Function<dim> (n_components),
+      coordinate (coordinate)
+    {}
+
+    virtual double value (const Point<dim> &p,
+                          const unsigned int component) const
+    {
+      return (coordinate < dim ? p[coordinate] : double(component));
+    }
+
+  private:
+    const unsigned int coordinate;
+  };
+}
+
+
+template <int dim>
+BoundaryDataCache<dim>::BoundaryDataCache ()
+  :
+  n_function_evaluations (0),
+  reference (0),
+  check (0),
+  separable (false),
+  has_values (false),
+  current_time (0.0)
+{}
+
+
+template <int dim>
+void
+BoundaryDataCache<dim>::initialize (
+  const Mapping<dim> &mapping,
+  const DoFHandler<dim> &dh,
+  const map<types::boundary_id, const Function<dim> *> &function_map,
+  const ComponentMask &component_mask,
+  Function<dim> &time_dependent_function,
+  const bool declared_separable)
+{
+  function = &time_dependent_function;
+  n_function_evaluations = 0;
+  separable = false;
+  has_values = false;
+  profile.clear ();
+
+  const unsigned int n_components = dh.get_fe().n_components();
+
+// A dof shared by faces with different boundary indicators takes the
+// value of the last face visited. To reproduce this, the boundary is
+// first interpolated with constant functions equal to the position of
+// each boundary function in the list below.
+  vector<const Function<dim> *> functions;
+  vector< std::shared_ptr<Functions::ConstantFunction<dim> > > index_functions;
+  map<types::boundary_id, const Function<dim> *> index_map;
+
+  typename map<types::boundary_id, const Function<dim> *>::const_iterator
+  it    = function_map.begin(),
+  itend = function_map.end();
+  for (; it != itend; ++it)
+    {
+      unsigned int f = 0;
+      while (f < functions.size() && functions[f] != it->second) ++f;
+      if (f == functions.size())
+        {
+          functions.push_back (it->second);
+          index_functions.push_back (std::make_shared<Functions::ConstantFunction<dim> >
+                                     (double(f), n_components));
+        }
+      index_map[it->first] = index_functions[f].get();
+    }
+
+  map<unsigned int, double> function_index;
+  VectorTools::interpolate_boundary_values (mapping, dh, index_map,
+                                            function_index, component_mask);
+
+// Coordinates of the support points, followed by the components.
+  vector< map<unsigned int, double> > support (dim+1);
+  for (unsigned int d=0; d<dim+1; ++d)
+    {
+      SupportPointFunction<dim> support_function (n_components, d);
+      map<types::boundary_id, const Function<dim> *> support_map;
+      for (it = function_map.begin(); it != itend; ++it)
+        support_map[it->first] = &support_function;
+
+      VectorTools::interpolate_boundary_values (mapping, dh, support_map,
+                                                support[d], component_mask);
+    }
+
+  const unsigned int n = function_index.size();
+  dofs.resize (n);
+  points.resize (n);
+  components.resize (n);
+  time_dependent.resize (n);
+  values.resize (n);
+
+  unsigned int i = 0;
+  map<unsigned int, double>::const_iterator
+  dof    = function_index.begin(),
+  dofend = function_index.end();
+  for (; dof != dofend; ++dof, ++i)
+    {
+      dofs[i] = dof->first;
+      for (unsigned int d=0; d<dim; ++d)
+        points[i][d] = support[d][dof->first];
+      components[i] = static_cast<unsigned int>(std::lround (support[dim][dof->first]));
+
+      const Function<dim> *f
+        = functions[static_cast<unsigned int>(std::lround (dof->second))];
+      time_dependent[i] = (f == &time_dependent_function);
+
+// The other functions are evaluated once and for all.
+      if (!time_dependent[i])
+        values[i] = f->value (points[i], components[i]);
+    }
+
+  separable = declared_separable;
+}
+
+
+// The profile is the first set of values of the time dependent function
+// that does not vanish. Its largest entry is the one the time factor is
+// computed from.
+
+template <int dim>
+void
+BoundaryDataCache<dim>::set_profile ()
+{
+  const unsigned int n = dofs.size();
+
+  double max_profile = 0;
+  for (unsigned int j=0; j<n; ++j)
+    if (time_dependent[j] && (std::fabs(values[j]) > max_profile))
+      {
+        max_profile = std::fabs(values[j]);
+        reference = j;
+      }
+  if (max_profile == 0)
+    return;
+
+  profile = values;
+
+// The check is done, if possible, at a different point, otherwise at
+// a different component of the same point.
+  check = reference;
+  for (unsigned int pass=0; (pass<2) && (check == reference); ++pass)
+    {
+      double max_check = 0;
+      for (unsigned int j=0; j<n; ++j)
+        if (time_dependent[j] && (j != reference) &&
+            (std::fabs(profile[j]) > max_check) &&
+            ((pass == 1) || (points[j].distance(points[reference]) > 0)))
+          {
+            max_check = std::fabs(profile[j]);
+            check = j;
+          }
+    }
+}
+
+
+template <int dim>
+void
+BoundaryDataCache<dim>::evaluate_all (const double t,
+                                      vector<double> &v)
+{
+  function->set_time (t);
+  for (unsigned int j=0; j<dofs.size(); ++j)
+    if (time_dependent[j])
+      {
+        v[j] = function->value (points[j], components[j]);
+        ++n_function_evaluations;
+      }
+}
+
+
+template <int dim>
+void
+BoundaryDataCache<dim>::evaluate (const double t,
+                                  DenseBoundaryValues &boundary_values)
+{
+  Assert (function != 0, ExcNotInitialized());
+
+  if (has_values && (t == current_time))
+    return;
+
+// Separable data only need the time factor, once the profile is known.
+// The value at the check dof catches data that were wrongly declared
+// separable.
+  bool done = false;
+  if (separable && !profile.empty())
+    {
+      function->set_time (t);
+      const double g = function->value (points[reference], components[reference])
+                       / profile[reference];
+      const double check_value = function->value (points[check], components[check]);
+      n_function_evaluations += 2;
+
+      if (std::fabs(check_value - g*profile[check])
+          > separability_tolerance * std::fabs(profile[reference]) * (1.0 + std::fabs(g)))
+        {
+          cout << "Boundary data are not separable at time " << t
+               << ": they will be evaluated at all the boundary dofs."
+               << endl;
+          separable = false;
+        }
+      else
+        {
+          for (unsigned int j=0; j<dofs.size(); ++j)
+            if (time_dependent[j])
+              values[j] = g*profile[j];
+          done = true;
+        }
+    }
+
+  if (!done)
+    {
+      evaluate_all (t, values);
+      if (separable)
+        set_profile ();
+    }
+
+  for (unsigned int j=0; j<dofs.size(); ++j)
+    boundary_values.set (dofs[j], values[j]);
+
+  current_time = t;
+  has_values = true;
+}
+
+
+template <int dim>
+void
+BoundaryDataCache<dim>::invalidate ()
+{
+  has_values = false;
+}
+
+
+template class BoundaryDataCache<2>;
+template class BoundaryDataCache<3>;
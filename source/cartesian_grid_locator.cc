@@ -0,0 +1,212 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#include "cartesian_grid_locator.h"
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/grid/tria.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+
+template <int dim>
+CartesianGridLocator<dim>::CartesianGridLocator ()
+  :
+  tolerance (0)
+{
+  for (unsigned int d=0; d<dim; ++d)
+    n_cells[d] = 0;
+}
+
+
+template <int dim>
+void
+CartesianGridLocator<dim>::clear ()
+{
+  cells.clear ();
+}
+
+
+// The size of the cells is taken from the first one. Every cell is then
+// checked to be a box of the same size, whose vertex <code>v</code> is
+// displaced from vertex 0 by one cell size along each direction
+// <code>d</code> in which bit <code>d</code> of <code>v</code> is set, and
+// to fill its own slot of the lattice spanned by the bounding box.
+
+template <int dim>
+bool
+CartesianGridLocator<dim>::initialize (const DoFHandler<dim> &dh)
+{
+  clear ();
+
+  cell_iterator cell = dh.begin_active(), endc = dh.end();
+  if (cell == endc)
+    return false;
+
+  double min_size = 0;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      cell_size[d] = cell->vertex(1<<d)[d] - cell->vertex(0)[d];
+      if (cell_size[d] <= 0)
+        return false;
+      min_size = (d == 0 ? cell_size[d] : std::min (min_size, cell_size[d]));
+    }
+  tolerance = 1e-8 * min_size;
+
+  lower_corner = cell->vertex(0);
+  Point<dim> upper_corner = cell->vertex(0);
+  for (; cell != endc; ++cell)
+    {
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          Point<dim> expected = cell->vertex(0);
+          for (unsigned int d=0; d<dim; ++d)
+            if (v & (1<<d))
+              expected[d] += cell_size[d];
+          if (expected.distance (cell->vertex(v)) > tolerance)
+            return false;
+        }
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          lower_corner[d] = std::min (lower_corner[d], cell->vertex(0)[d]);
+          upper_corner[d] = std::max (upper_corner[d], cell->vertex(0)[d] + cell_size[d]);
+        }
+    }
+
+  unsigned int n_slots = 1;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      n_cells[d] = static_cast<unsigned int>(std::floor ((upper_corner[d]-lower_corner[d])
+                                                         / cell_size[d] + 0.5));
+      n_slots *= n_cells[d];
+    }
+  if (n_slots != dh.get_triangulation().n_active_cells())
+    return false;
+
+  vector<cell_iterator> slots (n_slots, endc);
+  for (cell = dh.begin_active(); cell != endc; ++cell)
+    {
+      Point<dim> center = cell->vertex(0);
+      for (unsigned int d=0; d<dim; ++d)
+        center[d] += 0.5*cell_size[d];
+
+      Point<dim> unit_point;
+      const unsigned int slot = cell_index (center, unit_point);
+      if (slot == numbers::invalid_unsigned_int || slots[slot] != endc)
+        return false;
+      slots[slot] = cell;
+    }
+
+  cells.swap (slots);
+  return true;
+}
+
+
+// Lexicographic index of the cell containing <code>p</code>. Points on
+// the boundary of the grid, within the tolerance, belong to the cells
+// next to it.
+
+template <int dim>
+unsigned int
+CartesianGridLocator<dim>::cell_index (const Point<dim> &p,
+                                       Point<dim> &unit_point) const
+{
+  unsigned int index = 0;
+  for (unsigned int d=dim; d>0; --d)
+    {
+      const double x = (p[d-1] - lower_corner[d-1]) / cell_size[d-1];
+      if (x < -tolerance/cell_size[d-1]
+          ||
+          x > n_cells[d-1] + tolerance/cell_size[d-1])
+        return numbers::invalid_unsigned_int;
+
+      const unsigned int i = std::min (static_cast<unsigned int>(std::max (std::floor (x), 0.)),
+                                       n_cells[d-1]-1);
+      unit_point[d-1] = std::min (std::max (x - i, 0.), 1.);
+      index = index*n_cells[d-1] + i;
+    }
+  return index;
+}
+
+
+template <int dim>
+bool
+CartesianGridLocator<dim>::locate (const Point<dim> &p,
+                                   cell_iterator &cell,
+                                   Point<dim> &unit_point) const
+{
+  Assert (is_cartesian(), ExcNotInitialized());
+
+  const unsigned int index = cell_index (p, unit_point);
+  if (index == numbers::invalid_unsigned_int)
+    return false;
+
+  cell = cells[index];
+  return true;
+}
+
+
+// The points are grouped by sorting them by the index of the cell
+// containing them, which stays cheap also when all the points of the
+// immersed domain are located at once.
+
+template <int dim>
+unsigned int
+CartesianGridLocator<dim>::compute_point_locations (
+  const vector< Point<dim> > &points,
+  vector<cell_iterator> &point_cells,
+  vector< vector< Point<dim> > > &qpoints,
+  vector< vector<unsigned int> > &maps) const
+{
+  Assert (is_cartesian(), ExcNotInitialized());
+
+  vector< pair<unsigned int, unsigned int> > indices (points.size());
+  vector< Point<dim> > unit_points (points.size());
+  for (unsigned int q=0; q<points.size(); ++q)
+    {
+      indices[q].first = cell_index (points[q], unit_points[q]);
+      indices[q].second = q;
+      if (indices[q].first == numbers::invalid_unsigned_int)
+        {
+          ostringstream message;
+          message << "The point (" << points[q] << ") is outside of the grid.";
+          AssertThrow (false, ExcMessage (message.str()));
+        }
+    }
+  std::sort (indices.begin(), indices.end());
+
+  point_cells.clear ();
+  qpoints.clear ();
+  maps.clear ();
+  for (unsigned int i=0; i<indices.size(); ++i)
+    {
+      if (i == 0 || indices[i].first != indices[i-1].first)
+        {
+          point_cells.push_back (cells[indices[i].first]);
+          qpoints.push_back (vector< Point<dim> >());
+          maps.push_back (vector<unsigned int>());
+        }
+      qpoints.back().push_back (unit_points[indices[i].second]);
+      maps.back().push_back (indices[i].second);
+    }
+
+  return point_cells.size();
+}
+
+
+template class CartesianGridLocator<2>;
+template class CartesianGridLocator<3>;
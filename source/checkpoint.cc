@@ -0,0 +1,331 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#include "checkpoint.h"
+
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+
+namespace
+{
+// The header is written field by field, in the byte order of the
+// machine: checkpoints are meant to be read back on the same kind of
+// machine that wrote them.
+  const char magic[8] = {'I', 'F', 'E', 'M', 'C', 'K', 'P', 'T'};
+
+  template <typename T>
+  void write_field (ofstream &out, const T &value)
+  {
+    out.write (reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool read_field (ifstream &in, T &value)
+  {
+    in.read (reinterpret_cast<char *>(&value), sizeof(T));
+    return in.good();
+  }
+
+  string list_name (const string &prefix)
+  {
+    return prefix + "checkpoints.txt";
+  }
+
+  string marker_name (const string &checkpoint_name)
+  {
+    return checkpoint_name + ".done";
+  }
+}
+
+
+uint64_t
+fnv1a_checksum (const char *data,
+                const size_t size)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i=0; i<size; ++i)
+    {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+
+bool
+file_exists (const string &filename)
+{
+  ifstream in (filename.c_str());
+  return in.good();
+}
+
+
+void
+write_checkpoint (const string &filename,
+                  const string &data)
+{
+  const string tmp_name = filename + ".tmp";
+  {
+    ofstream out (tmp_name.c_str(), ios::binary);
+    AssertThrow (out, ExcMessage ("Can't open the checkpoint file " + tmp_name + "."));
+
+    const uint32_t version = checkpoint_format_version;
+    const uint64_t size = data.size();
+    const uint64_t checksum = fnv1a_checksum (data.data(), data.size());
+
+    out.write (magic, sizeof(magic));
+    write_field (out, version);
+    write_field (out, size);
+    write_field (out, checksum);
+    out.write (data.data(), data.size());
+
+    out.flush ();
+    AssertThrow (out, ExcMessage ("Can't write the checkpoint file " + tmp_name + "."));
+  }
+
+  AssertThrow (std::rename (tmp_name.c_str(), filename.c_str()) == 0,
+               ExcMessage ("Can't move files: " + tmp_name + " -> " + filename));
+}
+
+
+string
+read_checkpoint (const string &filename)
+{
+  ifstream in (filename.c_str(), ios::binary);
+  AssertThrow (in, ExcMessage ("Can't open the checkpoint file " + filename + "."));
+
+  char file_magic[sizeof(magic)];
+  in.read (file_magic, sizeof(file_magic));
+  AssertThrow (in && (std::memcmp (file_magic, magic, sizeof(magic)) == 0),
+               ExcMessage ("The file " + filename + " is not a checkpoint."));
+
+  uint32_t version = 0;
+  uint64_t size = 0;
+  uint64_t checksum = 0;
+  AssertThrow (read_field (in, version) && read_field (in, size)
+               && read_field (in, checksum),
+               ExcMessage ("The header of the checkpoint " + filename
+                           + " is truncated."));
+  AssertThrow (version == checkpoint_format_version,
+               ExcMessage ("The checkpoint " + filename + " has format version "
+                           + Utilities::to_string (version) + ", but version "
+                           + Utilities::to_string (checkpoint_format_version)
+                           + " is needed."));
+
+// The data are read with a single call.
+  string data (size, '\0');
+  in.read (&data[0], size);
+  AssertThrow (in.gcount() == static_cast<streamsize>(size),
+               ExcMessage ("The checkpoint " + filename + " is truncated."));
+  AssertThrow (fnv1a_checksum (data.data(), data.size()) == checksum,
+               ExcMessage ("The checksum of the checkpoint " + filename
+                           + " does not match its data."));
+
+  return data;
+}
+
+
+vector<string>
+complete_checkpoints (const string &prefix)
+{
+  vector<string> names;
+  ifstream list (list_name (prefix).c_str());
+  string name;
+  while (getline (list, name))
+    if (!name.empty() && file_exists (marker_name (name)))
+      names.push_back (name);
+  return names;
+}
+
+
+CheckpointWriter::CheckpointWriter ()
+  :
+  n_kept (1),
+  background (false),
+  last_step (numbers::invalid_unsigned_int)
+{}
+
+
+CheckpointWriter::~CheckpointWriter ()
+{
+// A destructor must not throw: a failure of the last write can only be
+// reported.
+  try
+    {
+      wait ();
+    }
+  catch (const std::exception &exc)
+    {
+      cerr << exc.what() << endl;
+    }
+  catch (...)
+    {
+      cerr
+          << " The checkpoint "
+          << pending_name
+          << " could not be written."
+          << endl;
+    }
+}
+
+
+void
+CheckpointWriter::initialize (const string &file_prefix,
+                              const unsigned int n,
+                              const bool in_background)
+{
+  wait ();
+
+  prefix = file_prefix;
+  n_kept = std::max (n, 1u);
+  background = in_background;
+
+  const vector<string> names = complete_checkpoints (prefix);
+  kept.assign (names.begin(), names.end());
+  discarded.clear ();
+}
+
+
+void
+CheckpointWriter::restored (const string &name)
+{
+  wait ();
+
+  const deque<string>::iterator p = std::find (kept.begin(), kept.end(), name);
+  if (p == kept.end())
+    return;
+
+  discarded.insert (discarded.end(), p+1, kept.end());
+  kept.erase (p+1, kept.end());
+}
+
+
+void
+CheckpointWriter::write (const unsigned int time_step,
+                         string &data)
+{
+  wait ();
+
+  last_step = time_step;
+  pending_name = (prefix
+                  + "checkpoint-"
+                  + Utilities::int_to_string (time_step, 5)
+                  + ".bin");
+  pending_data.swap (data);
+  data.clear ();
+
+  if (background)
+    task = Threads::new_task (&CheckpointWriter::write_in_background, *this);
+  else
+    write_and_rotate ();
+}
+
+
+void
+CheckpointWriter::wait ()
+{
+  if (task.joinable())
+    task.join ();
+  task = Threads::Task<void>();
+
+  if (!background_error.empty())
+    {
+      string message;
+      message.swap (background_error);
+      AssertThrow (false, ExcMessage ("The checkpoint " + pending_name
+                                      + " could not be written: " + message));
+    }
+}
+
+
+// An exception escaping a task aborts the program, so failures of the
+// background writes are only recorded here, and thrown by
+// <code>wait()</code> on the thread that requested the checkpoint.
+
+void
+CheckpointWriter::write_in_background ()
+{
+  try
+    {
+      write_and_rotate ();
+    }
+  catch (const std::exception &exc)
+    {
+      background_error = exc.what();
+    }
+  catch (...)
+    {
+      background_error = "unknown exception";
+    }
+}
+
+
+// The marker is written only once the checkpoint has its final name,
+// and the list only mentions checkpoints with a marker. The list itself
+// is replaced atomically, and older checkpoints are only removed after
+// it no longer mentions them.
+
+void
+CheckpointWriter::write_and_rotate ()
+{
+  write_checkpoint (pending_name, pending_data);
+  string().swap (pending_data);
+
+  {
+    ofstream marker (marker_name (pending_name).c_str());
+    marker << "complete" << endl;
+    AssertThrow (marker, ExcMessage ("Can't write the marker of the checkpoint "
+                                     + pending_name + "."));
+  }
+
+// A checkpoint of the same time step, written before a restart, is
+// replaced rather than listed twice.
+  kept.erase (std::remove (kept.begin(), kept.end(), pending_name),
+              kept.end());
+  kept.push_back (pending_name);
+
+  vector<string> removed;
+  removed.swap (discarded);
+  while (kept.size() > n_kept)
+    {
+      removed.push_back (kept.front());
+      kept.pop_front ();
+    }
+
+  const string tmp_name = list_name (prefix) + ".tmp";
+  {
+    ofstream list (tmp_name.c_str());
+    for (unsigned int i=0; i<kept.size(); ++i)
+      list << kept[i] << endl;
+    AssertThrow (list, ExcMessage ("Can't write the list of checkpoints "
+                                   + tmp_name + "."));
+  }
+  AssertThrow (std::rename (tmp_name.c_str(), list_name (prefix).c_str()) == 0,
+               ExcMessage ("Can't move files: " + tmp_name + " -> "
+                           + list_name (prefix)));
+
+  for (unsigned int i=0; i<removed.size(); ++i)
+    if (std::find (kept.begin(), kept.end(), removed[i]) == kept.end())
+      {
+        std::remove (marker_name (removed[i]).c_str());
+        std::remove (removed[i].c_str());
+      }
+}
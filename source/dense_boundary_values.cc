@@ -0,0 +1,47 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "dense_boundary_values.h"
+
+
+void
+DenseBoundaryValues::reinit (const unsigned int n_dofs)
+{
+  values.assign (n_dofs, 0.0);
+  constrained.assign (n_dofs, false);
+  dofs.clear ();
+}
+
+
+// Only the flags of the previously constrained dofs are reset, so the
+// cost is proportional to the number of boundary dofs, not to the
+// total number of dofs.
+
+void
+DenseBoundaryValues::set (const map<unsigned int, double> &boundary_values)
+{
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    {
+      constrained[dofs[i]] = false;
+      values[dofs[i]] = 0.0;
+    }
+  dofs.clear ();
+
+  map<unsigned int, double>::const_iterator
+  it    = boundary_values.begin(),
+  itend = boundary_values.end();
+  for (; it != itend; ++it)
+    set (it->first, it->second);
+}
@@ -0,0 +1,584 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "direct_solver.h"
+
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/std_cxx14/memory.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#ifdef DEAL_II_WITH_TRILINOS
+#  include <deal.II/base/index_set.h>
+#  include <deal.II/lac/solver_control.h>
+#  include <deal.II/lac/trilinos_sparse_matrix.h>
+#  include <deal.II/lac/trilinos_vector.h>
+#  include <deal.II/lac/trilinos_solver.h>
+#endif
+
+#ifdef DEAL_II_WITH_UMFPACK
+#  include <umfpack.h>
+#endif
+
+#if !defined(DEAL_II_WITH_UMFPACK) && !defined(DEAL_II_WITH_TRILINOS)
+#  error "A sparse direct solver is needed: configure deal.II with UMFPACK or Trilinos."
+#endif
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+DirectSolver::Statistics::Statistics ()
+  :
+  n_factorizations (0),
+  last_factorization_time (0.0),
+  total_factorization_time (0.0),
+  matrix_nonzeros (0.0),
+  factor_nonzeros (0.0),
+  flops (0.0),
+  peak_memory (0.0)
+{}
+
+
+DirectSolver::DirectSolver ()
+  :
+  ordering (automatic)
+{}
+
+
+DirectSolver::~DirectSolver ()
+{}
+
+
+void
+DirectSolver::set_ordering (const Ordering new_ordering,
+                            const vector<unsigned int> &columns)
+{
+  Assert ((new_ordering != given) || !columns.empty(),
+          ExcMessage ("A given ordering needs the list of columns."));
+  ordering = new_ordering;
+  given_ordering = columns;
+}
+
+
+namespace
+{
+// Copies between the blocks of a block vector and contiguous storage,
+// one block at a time rather than through the iterators of the block
+// vector, which look up the block of each entry.
+  void gather (const BlockVector<double> &src,
+               Vector<double> &dst)
+  {
+    dst.reinit (src.size(), true);
+    double *p = dst.begin();
+    for (unsigned int b=0; b<src.n_blocks(); ++b)
+      p = std::copy (src.block(b).begin(), src.block(b).end(), p);
+  }
+
+
+  void scatter (const Vector<double> &src,
+                BlockVector<double> &dst)
+  {
+    AssertDimension (src.size(), dst.size());
+    const double *p = src.begin();
+    for (unsigned int b=0; b<dst.n_blocks(); ++b)
+      {
+        std::copy (p, p + dst.block(b).size(), dst.block(b).begin());
+        p += dst.block(b).size();
+      }
+  }
+}
+
+
+void
+DirectSolver::solve (Vector<double> &rhs_and_solution) const
+{
+  tmp = rhs_and_solution;
+  solve (rhs_and_solution.begin(), tmp.begin());
+}
+
+
+void
+DirectSolver::solve (BlockVector<double> &rhs_and_solution) const
+{
+  if (rhs_and_solution.n_blocks() == 1)
+    {
+      solve (rhs_and_solution.block(0));
+      return;
+    }
+
+  gather (rhs_and_solution, tmp);
+  tmp_solution.reinit (tmp.size(), true);
+  solve (tmp_solution.begin(), tmp.begin());
+  scatter (tmp_solution, rhs_and_solution);
+}
+
+
+void
+DirectSolver::vmult (Vector<double> &dst,
+                     const Vector<double> &src) const
+{
+  Assert (&dst != &src, ExcMessage ("The arguments must be different vectors."));
+  AssertDimension (dst.size(), src.size());
+
+  solve (dst.begin(), src.begin());
+}
+
+
+void
+DirectSolver::vmult (BlockVector<double> &dst,
+                     const BlockVector<double> &src) const
+{
+  Assert (&dst != &src, ExcMessage ("The arguments must be different vectors."));
+  AssertDimension (dst.n_blocks(), src.n_blocks());
+
+  if (src.n_blocks() == 1)
+    {
+      vmult (dst.block(0), src.block(0));
+      return;
+    }
+
+  gather (src, tmp);
+  tmp_solution.reinit (tmp.size(), true);
+  solve (tmp_solution.begin(), tmp.begin());
+  scatter (tmp_solution, dst);
+}
+
+
+void
+DirectSolver::print_statistics (ostream &out,
+                                const string &label) const
+{
+  out << " " << label << " (" << name() << "): "
+      << stats.n_factorizations << " factorizations in "
+      << stats.total_factorization_time << " s";
+  if (stats.peak_memory > 0)
+    out << ", peak memory " << stats.peak_memory/1048576. << " MB";
+  if (stats.factor_nonzeros > 0)
+    out << ", fill " << stats.factor_nonzeros/stats.matrix_nonzeros
+        << " (" << stats.factor_nonzeros << " nonzeros in the factors)";
+  if (stats.flops > 0)
+    out << ", " << stats.flops << " flops";
+  out << endl;
+}
+
+
+namespace
+{
+// Copy of a block matrix into a single sparse matrix, for the backends
+// that do not know about blocks.
+  void copy_to_sparse_matrix (const BlockSparseMatrix<double> &matrix,
+                              SparsityPattern &sparsity,
+                              SparseMatrix<double> &copy)
+  {
+    DynamicSparsityPattern dsp (matrix.m(), matrix.n());
+    for (unsigned int row=0; row<matrix.m(); ++row)
+      for (BlockSparseMatrix<double>::const_iterator it = matrix.begin(row);
+           it != matrix.end(row); ++it)
+        dsp.add (row, it->column());
+
+    copy.clear ();
+    sparsity.copy_from (dsp);
+    copy.reinit (sparsity);
+
+    for (unsigned int row=0; row<matrix.m(); ++row)
+      for (BlockSparseMatrix<double>::const_iterator it = matrix.begin(row);
+           it != matrix.end(row); ++it)
+        copy.set (row, it->column(), it->value());
+  }
+
+
+
+#ifdef DEAL_II_WITH_UMFPACK
+// UMFPACK, called directly rather than through SparseDirectUMFPACK, so
+// that its statistics are available. As in SparseDirectUMFPACK, the
+// matrix is handed over in compressed row format, which UMFPACK sees as
+// the compressed column format of the transpose, and the transpose
+// system is solved.
+  double umfpack_ordering (const DirectSolver::Ordering ordering)
+  {
+    switch (ordering)
+      {
+      case DirectSolver::natural:
+        return UMFPACK_ORDERING_NONE;
+      case DirectSolver::amd:
+        return UMFPACK_ORDERING_AMD;
+      case DirectSolver::metis:
+        return UMFPACK_ORDERING_METIS;
+      case DirectSolver::given:
+        return UMFPACK_ORDERING_GIVEN;
+      default:
+        return UMFPACK_DEFAULT_ORDERING;
+      }
+  }
+
+
+  class UMFPACKSolver : public DirectSolver
+  {
+  public:
+
+    UMFPACKSolver ();
+
+    ~UMFPACKSolver ();
+
+    string name () const
+    {
+      return "UMFPACK";
+    };
+
+    void initialize (const SparseMatrix<double> &matrix);
+
+    void initialize (const BlockSparseMatrix<double> &matrix);
+
+    void solve (double *solution,
+                const double *rhs) const;
+
+  private:
+
+    template <class MatrixType>
+    void factorize (const MatrixType &matrix);
+
+    void clear ();
+
+    void *numeric;
+
+    vector<SuiteSparse_long> Ap;
+
+    vector<SuiteSparse_long> Ai;
+
+    vector<double> Ax;
+
+    vector<double> control;
+  };
+
+
+  UMFPACKSolver::UMFPACKSolver ()
+    :
+    numeric (0),
+    control (UMFPACK_CONTROL)
+  {
+    umfpack_dl_defaults (&control[0]);
+  }
+
+
+  UMFPACKSolver::~UMFPACKSolver ()
+  {
+    clear ();
+  }
+
+
+  void
+  UMFPACKSolver::clear ()
+  {
+    if (numeric != 0)
+      umfpack_dl_free_numeric (&numeric);
+    numeric = 0;
+
+    Ap.clear ();
+    Ai.clear ();
+    Ax.clear ();
+  }
+
+
+  void
+  UMFPACKSolver::initialize (const SparseMatrix<double> &matrix)
+  {
+    factorize (matrix);
+  }
+
+
+  void
+  UMFPACKSolver::initialize (const BlockSparseMatrix<double> &matrix)
+  {
+    factorize (matrix);
+  }
+
+
+  template <class MatrixType>
+  void
+  UMFPACKSolver::factorize (const MatrixType &matrix)
+  {
+    Assert (matrix.m() == matrix.n(), ExcNotQuadratic());
+
+    Timer timer;
+    clear ();
+
+    const unsigned int N = matrix.m();
+
+// Row pointers, then column indices and values, sorted within each row
+// as required by UMFPACK.
+    Ap.resize (N+1);
+    Ap[0] = 0;
+    for (unsigned int row=0; row<N; ++row)
+      {
+        SuiteSparse_long n_entries = 0;
+        for (typename MatrixType::const_iterator it = matrix.begin(row);
+             it != matrix.end(row); ++it)
+          ++n_entries;
+        Ap[row+1] = Ap[row] + n_entries;
+      }
+
+    Ai.resize (Ap[N]);
+    Ax.resize (Ap[N]);
+
+    vector< pair<SuiteSparse_long, double> > row_entries;
+    for (unsigned int row=0; row<N; ++row)
+      {
+        row_entries.clear ();
+        for (typename MatrixType::const_iterator it = matrix.begin(row);
+             it != matrix.end(row); ++it)
+          row_entries.push_back (make_pair (static_cast<SuiteSparse_long>(it->column()),
+                                            it->value()));
+        sort (row_entries.begin(), row_entries.end());
+
+        for (unsigned int k=0; k<row_entries.size(); ++k)
+          {
+            Ai[Ap[row]+k] = row_entries[k].first;
+            Ax[Ap[row]+k] = row_entries[k].second;
+          }
+      }
+
+    double info[UMFPACK_INFO];
+    void *symbolic = 0;
+
+// A given ordering is passed as the initial column permutation;
+// otherwise UMFPACK computes its own, with the requested method. The
+// control array is set every time, since the ordering may have changed
+// since the last factorization.
+    control[UMFPACK_ORDERING] = umfpack_ordering (ordering);
+
+    vector<SuiteSparse_long> Qinit;
+    if (ordering == given)
+      {
+        AssertDimension (given_ordering.size(), N);
+        Qinit.assign (given_ordering.begin(), given_ordering.end());
+      }
+
+    SuiteSparse_long status = umfpack_dl_qsymbolic (N, N, &Ap[0], &Ai[0], &Ax[0],
+                                                    (Qinit.empty() ? 0 : &Qinit[0]),
+                                                    &symbolic, &control[0], info);
+    AssertThrow (status == UMFPACK_OK,
+                 ExcMessage ("UMFPACK symbolic factorization failed with status "
+                             + Utilities::to_string (status) + "."));
+
+    status = umfpack_dl_numeric (&Ap[0], &Ai[0], &Ax[0],
+                                 symbolic, &numeric, &control[0], info);
+    umfpack_dl_free_symbolic (&symbolic);
+    AssertThrow (status == UMFPACK_OK,
+                 ExcMessage ("UMFPACK numeric factorization failed with status "
+                             + Utilities::to_string (status) + "."));
+
+    ++stats.n_factorizations;
+    stats.last_factorization_time = timer.wall_time();
+    stats.total_factorization_time += stats.last_factorization_time;
+    stats.matrix_nonzeros = Ap[N];
+    stats.factor_nonzeros = info[UMFPACK_LNZ] + info[UMFPACK_UNZ];
+    stats.flops = info[UMFPACK_FLOPS];
+    stats.peak_memory = std::max (stats.peak_memory,
+                                  info[UMFPACK_PEAK_MEMORY]*info[UMFPACK_SIZE_OF_UNIT]);
+  }
+
+
+// UMFPACK reads the right hand side and writes the solution in
+// separate arrays, which are the ones of the caller.
+  void
+  UMFPACKSolver::solve (double *solution,
+                        const double *rhs) const
+  {
+    Assert (numeric != 0, ExcNotInitialized());
+
+    double info[UMFPACK_INFO];
+    const SuiteSparse_long status = umfpack_dl_solve (UMFPACK_At,
+                                                      &Ap[0], &Ai[0], &Ax[0],
+                                                      solution,
+                                                      rhs,
+                                                      numeric,
+                                                      &control[0],
+                                                      info);
+    AssertThrow (status == UMFPACK_OK,
+                 ExcMessage ("UMFPACK solve failed with status "
+                             + Utilities::to_string (status) + "."));
+  }
+#endif
+
+
+
+#ifdef DEAL_II_WITH_TRILINOS
+// The direct solvers of Trilinos, through Amesos, on the local
+// communicator. Depending on how Trilinos was configured, these include
+// KLU, the shared-memory version of MUMPS, and SuperLU. Amesos reports
+// neither the size of the factors nor the memory they use.
+  class AmesosSolver : public DirectSolver
+  {
+  public:
+
+    AmesosSolver (const string &solver_type);
+
+    string name () const
+    {
+      return solver_type;
+    };
+
+    void initialize (const SparseMatrix<double> &matrix);
+
+    void initialize (const BlockSparseMatrix<double> &matrix);
+
+    void solve (double *solution,
+                const double *rhs) const;
+
+  private:
+
+    const string solver_type;
+
+    SolverControl control;
+
+    TrilinosWrappers::SparseMatrix matrix;
+
+    std::unique_ptr<TrilinosWrappers::SolverDirect> solver;
+
+    SparsityPattern block_copy_sparsity;
+
+    SparseMatrix<double> block_copy;
+
+    mutable TrilinosWrappers::MPI::Vector rhs;
+
+    mutable TrilinosWrappers::MPI::Vector solution;
+  };
+
+
+  AmesosSolver::AmesosSolver (const string &type)
+    :
+    solver_type (type),
+    control (1, 0)
+  {}
+
+
+  void
+  AmesosSolver::initialize (const SparseMatrix<double> &A)
+  {
+    Timer timer;
+
+    matrix.reinit (A);
+    solver = std_cxx14::make_unique<TrilinosWrappers::SolverDirect>
+             (control,
+              TrilinosWrappers::SolverDirect::AdditionalData (false, solver_type));
+    solver->initialize (matrix);
+
+    const IndexSet all_rows = complete_index_set (A.m());
+    rhs.reinit (all_rows, MPI_COMM_SELF);
+    solution.reinit (all_rows, MPI_COMM_SELF);
+
+    ++stats.n_factorizations;
+    stats.last_factorization_time = timer.wall_time();
+    stats.total_factorization_time += stats.last_factorization_time;
+    stats.matrix_nonzeros = matrix.n_nonzero_elements();
+  }
+
+
+  void
+  AmesosSolver::initialize (const BlockSparseMatrix<double> &A)
+  {
+    copy_to_sparse_matrix (A, block_copy_sparsity, block_copy);
+    initialize (block_copy);
+  }
+
+
+// Amesos works on its own vectors, into and out of which the data are
+// copied.
+  void
+  AmesosSolver::solve (double *x,
+                       const double *b) const
+  {
+    Assert (solver, ExcNotInitialized());
+
+    std::copy (b, b + rhs.size(), rhs.begin());
+    solver->solve (solution, rhs);
+    std::copy (solution.begin(), solution.end(), x);
+  }
+#endif
+}
+
+
+string
+direct_solver_names ()
+{
+  string names;
+#ifdef DEAL_II_WITH_UMFPACK
+  names += "UMFPACK|";
+#endif
+#ifdef DEAL_II_WITH_TRILINOS
+  names += "Amesos_Klu|Amesos_Mumps|Amesos_Superlu|";
+#endif
+  return names.substr (0, names.size()-1);
+}
+
+
+string
+default_direct_solver ()
+{
+#ifdef DEAL_II_WITH_UMFPACK
+  return "UMFPACK";
+#else
+  return "Amesos_Klu";
+#endif
+}
+
+
+string
+direct_solver_ordering_names ()
+{
+  return "Automatic|Natural|AMD|METIS|Block interleaved|Joint fluid-solid"
+         "|Cell-local pressure";
+}
+
+
+// The last three are computed by the caller, and passed to the solver as
+// a given ordering.
+
+DirectSolver::Ordering
+direct_solver_ordering (const string &name)
+{
+  if (name == "Automatic")
+    return DirectSolver::automatic;
+  if (name == "Natural")
+    return DirectSolver::natural;
+  if (name == "AMD")
+    return DirectSolver::amd;
+  if (name == "METIS")
+    return DirectSolver::metis;
+  return DirectSolver::given;
+}
+
+
+std::unique_ptr<DirectSolver>
+create_direct_solver (const string &name)
+{
+#ifdef DEAL_II_WITH_UMFPACK
+  if (name == "UMFPACK")
+    return std_cxx14::make_unique<UMFPACKSolver> ();
+#endif
+
+#ifdef DEAL_II_WITH_TRILINOS
+  if (Utilities::match_at_string_start (name, "Amesos_"))
+    return std_cxx14::make_unique<AmesosSolver> (name);
+#endif
+
+  AssertThrow (false,
+               ExcMessage ("The direct solver " + name + " is not available. "
+                           "Available solvers: " + direct_solver_names() + "."));
+  return std::unique_ptr<DirectSolver>();
+}
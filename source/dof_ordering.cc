@@ -0,0 +1,185 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "dof_ordering.h"
+
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe.h>
+
+#include <algorithm>
+#include <utility>
+
+
+string
+dof_renumbering_names ()
+{
+  return "Cuthill-McKee|King|Minimum degree";
+}
+
+
+template <int dim>
+void
+renumber_dofs (DoFHandler<dim> &dh,
+               const string &strategy)
+{
+  if (strategy == "Cuthill-McKee")
+    DoFRenumbering::boost::Cuthill_McKee (dh);
+  else if (strategy == "King")
+    DoFRenumbering::boost::king_ordering (dh);
+  else if (strategy == "Minimum degree")
+    DoFRenumbering::boost::minimum_degree (dh);
+  else
+    AssertThrow (false,
+                 ExcMessage ("Unknown dof renumbering: " + strategy + "."));
+}
+
+
+// Each dof is given a key, its relative position within its own block,
+// and the dofs are sorted by key. Velocity dofs come before pressure
+// dofs with the same key.
+
+void
+block_interleaved_ordering (const unsigned int n_dofs_u,
+                            const unsigned int n_dofs_p,
+                            const unsigned int n_dofs_W,
+                            vector<unsigned int> &ordering)
+{
+  vector< pair<double, unsigned int> > keys;
+  keys.reserve (n_dofs_u + n_dofs_p);
+
+  for (unsigned int i=0; i<n_dofs_u; ++i)
+    keys.push_back (make_pair ((double) i/n_dofs_u, i));
+  for (unsigned int i=0; i<n_dofs_p; ++i)
+    keys.push_back (make_pair ((double) i/n_dofs_p, n_dofs_u + i));
+
+  stable_sort (keys.begin(), keys.end());
+
+  ordering.resize (n_dofs_u + n_dofs_p + n_dofs_W);
+  for (unsigned int k=0; k<keys.size(); ++k)
+    ordering[k] = keys[k].second;
+  for (unsigned int j=0; j<n_dofs_W; ++j)
+    ordering[n_dofs_u + n_dofs_p + j] = n_dofs_u + n_dofs_p + j;
+}
+
+
+void
+joint_fluid_solid_ordering (const unsigned int n_dofs_up,
+                            const SparsityPattern &solid_fluid,
+                            vector<unsigned int> &ordering)
+{
+  const unsigned int n_dofs_W = solid_fluid.n_rows();
+
+// The key of fluid dof i is (i, 0); the one of solid dof j is (f, 1),
+// f being the first fluid dof it is coupled to.
+  vector< pair< pair<unsigned int, unsigned int>, unsigned int> > keys;
+  keys.reserve (n_dofs_up + n_dofs_W);
+
+  for (unsigned int i=0; i<n_dofs_up; ++i)
+    keys.push_back (make_pair (make_pair (i, 0u), i));
+
+  for (unsigned int j=0; j<n_dofs_W; ++j)
+    {
+      unsigned int first_fluid_dof = n_dofs_up;
+      for (SparsityPattern::iterator it = solid_fluid.begin(j);
+           it != solid_fluid.end(j); ++it)
+        first_fluid_dof = std::min (first_fluid_dof,
+                                    static_cast<unsigned int>(it->column()));
+      keys.push_back (make_pair (make_pair (first_fluid_dof, 1u), n_dofs_up + j));
+    }
+
+  sort (keys.begin(), keys.end());
+
+  ordering.resize (keys.size());
+  for (unsigned int k=0; k<keys.size(); ++k)
+    ordering[k] = keys[k].second;
+}
+
+
+template <int dim>
+void
+cell_local_pressure_ordering (const DoFHandler<dim> &dh,
+                              const unsigned int n_dofs_W,
+                              vector<unsigned int> &ordering)
+{
+  const FiniteElement<dim> &fe = dh.get_fe();
+  const unsigned int n_dofs_up = dh.n_dofs();
+
+  vector<types::global_dof_index> dofs (fe.dofs_per_cell);
+
+// The cells are sorted by their first velocity dof, so that the
+// renumbering of the dofs is respected.
+  vector< pair<unsigned int, typename DoFHandler<dim>::active_cell_iterator> > cells;
+  cells.reserve (dh.get_triangulation().n_active_cells());
+
+  typename DoFHandler<dim>::active_cell_iterator
+  cell = dh.begin_active (),
+  endc = dh.end ();
+  for (; cell != endc; ++cell)
+    {
+      cell->get_dof_indices (dofs);
+      unsigned int first_velocity_dof = n_dofs_up;
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        if (fe.system_to_component_index(i).first < dim)
+          first_velocity_dof = std::min (first_velocity_dof,
+                                         static_cast<unsigned int>(dofs[i]));
+      cells.push_back (make_pair (first_velocity_dof, cell));
+    }
+
+  stable_sort (cells.begin(), cells.end(),
+               [] (const pair<unsigned int, typename DoFHandler<dim>::active_cell_iterator> &a,
+                   const pair<unsigned int, typename DoFHandler<dim>::active_cell_iterator> &b)
+  {
+    return a.first < b.first;
+  });
+
+  ordering.clear ();
+  ordering.reserve (n_dofs_up + n_dofs_W);
+  vector<bool> placed (n_dofs_up, false);
+
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      cells[c].second->get_dof_indices (dofs);
+
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        if (fe.system_to_component_index(i).first < dim && !placed[dofs[i]])
+          {
+            placed[dofs[i]] = true;
+            ordering.push_back (dofs[i]);
+          }
+
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        if (fe.system_to_component_index(i).first == dim && !placed[dofs[i]])
+          {
+            placed[dofs[i]] = true;
+            ordering.push_back (dofs[i]);
+          }
+    }
+
+  AssertDimension (ordering.size(), n_dofs_up);
+
+  for (unsigned int j=0; j<n_dofs_W; ++j)
+    ordering.push_back (n_dofs_up + j);
+}
+
+
+template void renumber_dofs (DoFHandler<2> &, const string &);
+template void renumber_dofs (DoFHandler<3> &, const string &);
+
+template void cell_local_pressure_ordering (const DoFHandler<2> &,
+                                            const unsigned int,
+                                            vector<unsigned int> &);
+template void cell_local_pressure_ordering (const DoFHandler<3> &,
+                                            const unsigned int,
+                                            vector<unsigned int> &);
@@ -0,0 +1,291 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#include "fluid_refinement.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/lac/constraint_matrix.h>
+
+#include <deal.II/numerics/error_estimator.h>
+#include <deal.II/numerics/fe_field_function.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <algorithm>
+#include <functional>
+
+
+// The cells containing the points are those found by
+// <code>FEFieldFunction</code>, as for the coupling of the fluid and
+// the solid. Each layer of the buffer is made of the cells touching a
+// vertex of the cells flagged so far.
+
+template <int dim>
+void
+flag_cells_around_points (const DoFHandler<dim> &dh,
+                          const vector< Point<dim> > &points,
+                          const unsigned int n_layers)
+{
+  const Vector<double> no_values (dh.n_dofs());
+  Functions::FEFieldFunction<dim, DoFHandler<dim>, Vector<double> >
+  locator (dh, no_values);
+
+  vector< typename DoFHandler<dim>::active_cell_iterator > cells;
+  vector< vector< Point<dim> > > qpoints;
+  vector< vector< unsigned int > > maps;
+  locator.compute_point_locations (points, cells, qpoints, maps);
+
+  for (unsigned int c=0; c<cells.size(); ++c)
+    cells[c]->set_refine_flag ();
+
+  const Triangulation<dim> &tria = dh.get_triangulation();
+  typename Triangulation<dim>::active_cell_iterator cell, endc = tria.end();
+
+  for (unsigned int layer=0; layer<n_layers; ++layer)
+    {
+      vector<bool> flagged_vertices (tria.n_vertices(), false);
+      for (cell = tria.begin_active(); cell != endc; ++cell)
+        if (cell->refine_flag_set())
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            flagged_vertices[cell->vertex_index(v)] = true;
+
+      for (cell = tria.begin_active(); cell != endc; ++cell)
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          if (flagged_vertices[cell->vertex_index(v)])
+            {
+              cell->set_refine_flag ();
+              break;
+            }
+    }
+}
+
+
+template <int dim>
+void
+flag_cells_by_kelly_estimator (const DoFHandler<dim> &dh,
+                               const Vector<double> &up,
+                               const double fraction)
+{
+  const unsigned int n_cells = dh.get_triangulation().n_active_cells();
+  const unsigned int n_flagged = static_cast<unsigned int>(fraction*n_cells);
+  if (n_flagged == 0)
+    return;
+
+  vector<bool> velocity (dim+1, true);
+  velocity[dim] = false;
+
+  Vector<float> indicators (n_cells);
+  KellyErrorEstimator<dim>::estimate (dh,
+                                      QGauss<dim-1>(dh.get_fe().degree+1),
+                                      typename FunctionMap<dim>::type(),
+                                      up,
+                                      indicators,
+                                      ComponentMask (velocity));
+
+// The threshold is the smallest of the <code>n_flagged</code> largest
+// indicators.
+  vector<float> sorted (indicators.begin(), indicators.end());
+  nth_element (sorted.begin(), sorted.begin() + (n_flagged-1), sorted.end(),
+               std::greater<float>());
+  const float threshold = sorted[n_flagged-1];
+
+  typename DoFHandler<dim>::active_cell_iterator
+  cell = dh.begin_active(),
+  endc = dh.end();
+  for (; cell != endc; ++cell)
+    if (indicators(cell->active_cell_index()) >= threshold)
+      cell->set_refine_flag ();
+}
+
+
+template <int dim>
+void
+flag_cells_for_remeshing (const DoFHandler<dim> &dh,
+                          const vector< Point<dim> > &points,
+                          const Vector<double> &up,
+                          const unsigned int n_layers,
+                          const double kelly_fraction,
+                          const unsigned int min_level,
+                          const unsigned int max_level)
+{
+  const Triangulation<dim> &tria = dh.get_triangulation();
+  typename Triangulation<dim>::active_cell_iterator
+  cell = tria.begin_active(),
+  endc = tria.end();
+  for (; cell != endc; ++cell)
+    {
+      cell->clear_refine_flag ();
+      cell->clear_coarsen_flag ();
+    }
+
+  flag_cells_around_points (dh, points, n_layers);
+  if (kelly_fraction > 0)
+    flag_cells_by_kelly_estimator (dh, up, kelly_fraction);
+
+  for (cell = tria.begin_active(); cell != endc; ++cell)
+    if (cell->refine_flag_set())
+      {
+        if (static_cast<unsigned int>(cell->level()) >= max_level)
+          cell->clear_refine_flag ();
+      }
+    else if (static_cast<unsigned int>(cell->level()) > min_level)
+      cell->set_coarsen_flag ();
+}
+
+
+template <int dim>
+void
+refine_around_immersed_domain (Triangulation<dim> &tria_f,
+                               const Triangulation<dim> &tria_s,
+                               const FiniteElement<dim> &fe_f,
+                               const Quadrature<dim> &quad_s,
+                               const IFEMParameters<dim> &par)
+{
+  if (par.adaptive_cycles_f == 0)
+    return;
+
+// Points of the immersed domain in its initial configuration.
+  vector< Point<dim> > points;
+  points.reserve (tria_s.n_active_cells() * quad_s.size());
+
+  typename Triangulation<dim>::active_cell_iterator
+  cell = tria_s.begin_active(),
+  endc = tria_s.end();
+  for (; cell != endc; ++cell)
+    for (unsigned int q=0; q<quad_s.size(); ++q)
+      {
+        const Point<dim> X = StaticMappingQ1<dim>::mapping
+                             .transform_unit_to_real_cell (cell, quad_s.point(q));
+        Point<dim> x = X;
+        for (unsigned int d=0; d<dim; ++d)
+          x[d] += par.W_0.value (X, d);
+        points.push_back (x);
+      }
+
+  DoFHandler<dim> dh (tria_f);
+  Vector<double> up;
+
+  for (unsigned int cycle=0; cycle<par.adaptive_cycles_f; ++cycle)
+    {
+      dh.distribute_dofs (fe_f);
+      flag_cells_around_points (dh, points, par.buffer_layers_f);
+
+      if (par.kelly_fraction_f > 0)
+        {
+          ConstraintMatrix hanging_nodes;
+          DoFTools::make_hanging_node_constraints (dh, hanging_nodes);
+          hanging_nodes.close ();
+
+          up.reinit (dh.n_dofs());
+          if (fe_f.has_support_points())
+            {
+              VectorTools::interpolate (dh, par.u_0, up);
+              hanging_nodes.distribute (up);
+            }
+          else
+            VectorTools::project (dh,
+                                  hanging_nodes,
+                                  QGauss<dim>(fe_f.degree+2),
+                                  par.u_0,
+                                  up);
+
+          flag_cells_by_kelly_estimator (dh, up, par.kelly_fraction_f);
+        }
+
+      tria_f.execute_coarsening_and_refinement ();
+    }
+
+  dh.clear ();
+}
+
+
+template <int dim>
+string
+local_refinement_description (IFEMParameters<dim> &par)
+{
+  if (par.adaptive_cycles_f == 0)
+    return "";
+
+  string description
+    = " adaptive_cycles=" + Utilities::int_to_string (par.adaptive_cycles_f)
+      + " buffer_layers=" + Utilities::int_to_string (par.buffer_layers_f)
+      + " kelly_fraction=" + Utilities::to_string (par.kelly_fraction_f)
+      + " quad_s=" + Utilities::int_to_string (par.quad_s_type)
+      + "-" + Utilities::int_to_string (par.quad_s_degree);
+
+  const char *functions[] = {"W0", "u0"};
+  for (unsigned int f=0; f<2; ++f)
+    {
+      par.enter_subsection (functions[f]);
+      description += string(" ") + functions[f] + "="
+                     + par.get ("Function expression")
+                     + ";" + par.get ("Function constants");
+      par.leave_subsection ();
+    }
+
+  return description;
+}
+
+
+template void flag_cells_around_points (const DoFHandler<2> &,
+                                        const vector< Point<2> > &,
+                                        const unsigned int);
+template void flag_cells_around_points (const DoFHandler<3> &,
+                                        const vector< Point<3> > &,
+                                        const unsigned int);
+
+template void flag_cells_by_kelly_estimator (const DoFHandler<2> &,
+                                             const Vector<double> &,
+                                             const double);
+template void flag_cells_by_kelly_estimator (const DoFHandler<3> &,
+                                             const Vector<double> &,
+                                             const double);
+
+template void flag_cells_for_remeshing (const DoFHandler<2> &,
+                                        const vector< Point<2> > &,
+                                        const Vector<double> &,
+                                        const unsigned int,
+                                        const double,
+                                        const unsigned int,
+                                        const unsigned int);
+template void flag_cells_for_remeshing (const DoFHandler<3> &,
+                                        const vector< Point<3> > &,
+                                        const Vector<double> &,
+                                        const unsigned int,
+                                        const double,
+                                        const unsigned int,
+                                        const unsigned int);
+
+template void refine_around_immersed_domain (Triangulation<2> &,
+                                             const Triangulation<2> &,
+                                             const FiniteElement<2> &,
+                                             const Quadrature<2> &,
+                                             const IFEMParameters<2> &);
+template void refine_around_immersed_domain (Triangulation<3> &,
+                                             const Triangulation<3> &,
+                                             const FiniteElement<3> &,
+                                             const Quadrature<3> &,
+                                             const IFEMParameters<3> &);
+
+template string local_refinement_description (IFEMParameters<2> &);
+template string local_refinement_description (IFEMParameters<3> &);
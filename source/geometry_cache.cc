@@ -0,0 +1,108 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "geometry_cache.h"
+
+#include <deal.II/base/geometry_info.h>
+
+#include <algorithm>
+#include <limits>
+
+
+template <int dim>
+GeometryCache<dim>::GeometryCache ()
+  :
+  min_diameter (0.0),
+  max_diameter (0.0),
+  measure (0.0)
+{}
+
+
+template <int dim>
+void
+GeometryCache<dim>::initialize (const DoFHandler<dim> &dh)
+{
+  min_diameter = std::numeric_limits<double>::max();
+  max_diameter = 0.0;
+  measure = 0.0;
+  boundary_faces.clear ();
+  faces_by_boundary_id.clear ();
+  faces_by_manifold_id.clear ();
+  cells_by_manifold_id.clear ();
+
+  cell_iterator
+  cell = dh.begin_active(),
+  endc = dh.end();
+
+  for (; cell != endc; ++cell)
+    {
+      const double diameter = cell->diameter();
+      min_diameter = std::min (min_diameter, diameter);
+      max_diameter = std::max (max_diameter, diameter);
+      measure += cell->measure();
+
+      if (!cell->at_boundary())
+        continue;
+
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->face(f)->at_boundary())
+          {
+            const CellFace cell_face (cell, f);
+            const types::manifold_id manifold_id = cell->face(f)->manifold_id();
+
+            boundary_faces.push_back (cell_face);
+            faces_by_boundary_id[cell->face(f)->boundary_id()].push_back (cell_face);
+            faces_by_manifold_id[manifold_id].push_back (cell_face);
+
+            vector<cell_iterator> &cells = cells_by_manifold_id[manifold_id];
+            if (cells.empty() || (cells.back() != cell))
+              cells.push_back (cell);
+          }
+    }
+}
+
+
+template <int dim>
+const vector<typename GeometryCache<dim>::CellFace> &
+GeometryCache<dim>::faces_with_boundary_id (const types::boundary_id id) const
+{
+  typename map<types::boundary_id, vector<CellFace> >::const_iterator
+  it = faces_by_boundary_id.find (id);
+  return (it != faces_by_boundary_id.end() ? it->second : no_faces);
+}
+
+
+template <int dim>
+const vector<typename GeometryCache<dim>::CellFace> &
+GeometryCache<dim>::faces_with_manifold_id (const types::manifold_id id) const
+{
+  typename map<types::manifold_id, vector<CellFace> >::const_iterator
+  it = faces_by_manifold_id.find (id);
+  return (it != faces_by_manifold_id.end() ? it->second : no_faces);
+}
+
+
+template <int dim>
+const vector<typename GeometryCache<dim>::cell_iterator> &
+GeometryCache<dim>::cells_with_manifold_id (const types::manifold_id id) const
+{
+  typename map<types::manifold_id, vector<cell_iterator> >::const_iterator
+  it = cells_by_manifold_id.find (id);
+  return (it != cells_by_manifold_id.end() ? it->second : no_cells);
+}
+
+
+template class GeometryCache<2>;
+template class GeometryCache<3>;
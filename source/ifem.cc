@@ -47,7 +47,11 @@ IFEM<dim>::IFEM (IFEMParameters<dim> &par)
   fe_s (FE_Q<dim, dim>(par.degree), dim),
   dh_f (tria_f),
   dh_s (tria_s),
-  quad_f (par.degree+2)
+  quad_f (par.degree+2),
+  fd_jacobian (*this),
+  sparsity_coupling_stamp (numbers::invalid_unsigned_int),
+  sparsity_from_checkpoint (false),
+  fluid_mesh_from_checkpoint (false)
 {
   if (par.degree <= 1)
     cout
@@ -76,19 +80,44 @@ IFEM<dim>::IFEM (IFEMParameters<dim> &par)
       break;
     }
 
+  JF_inv = create_direct_solver (par.direct_solver);
+  M_gamma3_inv = create_direct_solver (par.direct_solver);
+
+  if (par.save_for_restart)
+    checkpoint_writer.initialize (par.output_name + par.file_info_for_restart,
+                                  par.n_checkpoints_kept,
+                                  par.background_checkpoints);
+
   if (par.this_is_a_restart)
     {
       global_info_file.open((par.output_name+"_global.gpl").c_str(), ios::app);
+      steps_file.open((par.output_name+"_steps.txt").c_str(), ios::app);
 
       if (par.fsi_bm)
         fsi_bm_out_file.open((par.output_name+"_fsi_bm.out").c_str(), ios::app);
+
+      if (!par.fluid_probe_points.empty() || !par.solid_probe_points.empty())
+        probes_out_file.open((par.output_name+"_probes.out").c_str(), ios::app);
     }
   else
     {
       global_info_file.open((par.output_name+"_global.gpl").c_str());
+      steps_file.open((par.output_name+"_steps.txt").c_str());
+      steps_file << "# step time dt" << endl;
 
       if (par.fsi_bm)
         fsi_bm_out_file.open((par.output_name+"_fsi_bm.out").c_str());
+
+      if (!par.fluid_probe_points.empty() || !par.solid_probe_points.empty())
+        {
+          probes_out_file.open((par.output_name+"_probes.out").c_str());
+          probes_out_file << "# time";
+          for (unsigned int i=0; i<par.fluid_probe_points.size(); ++i)
+            probes_out_file << "\tu,p(" << par.fluid_probe_points[i] << ")";
+          for (unsigned int i=0; i<par.solid_probe_points.size(); ++i)
+            probes_out_file << "\tw(" << par.solid_probe_points[i] << ")";
+          probes_out_file << endl;
+        }
     }
 
   create_triangulation_and_dofs ();
@@ -100,30 +129,28 @@ IFEM<dim>::IFEM (IFEMParameters<dim> &par)
 template <int dim>
 IFEM<dim>::~IFEM ()
 {
-  if (par.save_for_restart)
+  if (par.save_for_restart
+      &&
+      checkpoint_writer.last_time_step() != time_step)
     save_for_restart();
+  checkpoint_writer.wait ();
 }
 
 // Determination of the current value of time dependent boundary
-// values.
+// values. The boundary dofs and their support points were found in
+// <code>create_triangulation_and_dofs</code>, and the values are only
+// recomputed when the time changes.
 
 template <int dim>
 void
 IFEM<dim>::compute_current_bc (const double t)
 {
-  par.u_g.set_time(t);
-  VectorTools::interpolate_boundary_values (
-    StaticMappingQ1<dim>::mapping,
-    dh_f,
-    par.boundary_map,
-    par.boundary_values,
-    par.component_mask
-  );
+  boundary_data.evaluate (t, dense_boundary_values);
 
 // Set to zero the value of the first dof associated to
 // the pressure field.
   if ( (par.solid_is_compressible == false) && (par.fix_pressure == true))
-    par.boundary_values[constraining_dof] = 0;
+    dense_boundary_values.set (constraining_dof, 0);
 }
 
 // Application of time dependent boundary conditions.
@@ -137,18 +164,21 @@ IFEM<dim>::apply_current_bc
 )
 {
   compute_current_bc(t);
-  map<unsigned int, double>::iterator it    = par.boundary_values.begin(),
-                                      itend = par.boundary_values.end();
+  const vector<unsigned int> &dofs_f = dense_boundary_values.constrained_dofs();
   if (vec.size() != 0)
-    for (; it != itend; ++it)
-      vec.block(0)(it->first) = it->second;
+    for (unsigned int i=0; i<dofs_f.size(); ++i)
+      vec.block(0)(dofs_f[i]) = dense_boundary_values.value(dofs_f[i]);
   else
-    for (; it != itend; ++it)
-      constraints_f.set_inhomogeneity(it->first, it->second);
+    for (unsigned int i=0; i<dofs_f.size(); ++i)
+      constraints_f.set_inhomogeneity(dofs_f[i],
+                                      dense_boundary_values.value(dofs_f[i]));
 
   if (par.use_dbc_solid)
-    for (it=par.boundary_values_solid.begin(); it != par.boundary_values_solid.end(); ++it)
-      vec.block(1)(it->first) = it->second;
+    {
+      const vector<unsigned int> &dofs_s = dense_boundary_values_solid.constrained_dofs();
+      for (unsigned int i=0; i<dofs_s.size(); ++i)
+        vec.block(1)(dofs_s[i]) = dense_boundary_values_solid.value(dofs_s[i]);
+    }
 
 }
 
@@ -171,47 +201,93 @@ IFEM<dim>::create_triangulation_and_dofs ()
   tria_f.clear();
   tria_s.clear();
 
-  // As specified in the documentation for the "GridIn" class the
-  // triangulation corresponding to a grid needs to be empty at
-  // this time.
-  GridIn<dim> grid_in_f;
-  grid_in_f.attach_triangulation (tria_f);
-
+// The refined triangulations and the numbering of the dofs are read
+// from the setup cache, if it is enabled and holds them. The key of the
+// cache describes everything they depend on, including what determines
+// the sparsity of the fluid block, which is cached along with them.
   {
-    ifstream file (par.fluid_mesh.c_str());
-    Assert (file, ExcFileNotOpen (par.fluid_mesh.c_str()));
+    vector<string> mesh_files (1, par.fluid_mesh);
+    mesh_files.push_back (par.solid_mesh);
+    setup_cache.initialize (
+      par.setup_cache_directory,
+      "ifem ref_f=" + Utilities::int_to_string (par.ref_f)
+      + " ref_s=" + Utilities::int_to_string (par.ref_s)
+      + " fe_f=" + fe_f.get_name()
+      + " fe_s=" + fe_s.get_name()
+      + " renumbering=" + par.dof_renumbering
+      + " pressure_row=" + ((par.all_DBC && !par.solid_is_compressible
+                             && !par.project_pressure) ? "dense" : "none")
+      + local_refinement_description (par),
+      mesh_files);
+  }
 
+// A run that remeshed the control volume stores its triangulation in
+// the checkpoints: on restart, it replaces the one built from the mesh
+// file, and the setup cache, which only holds the initial setup, is
+// neither used nor written.
+  fluid_mesh_from_checkpoint = false;
+  if (par.this_is_a_restart && par.restart_step < 0)
+    fluid_mesh_from_checkpoint = restore_fluid_mesh ();
 
-    // A grid in ucd or msh format is expected.
-    if (boost::filesystem::extension(par.fluid_mesh) == "msh")
-      grid_in_f.read_msh (file);
-    else if (boost::filesystem::extension(par.fluid_mesh) == "inp")
-      grid_in_f.read_ucd (file);
-    else
-      AssertThrow(false, ExcMessage("Input file not supported."));
+  if (fluid_mesh_from_checkpoint || !setup_cache.load (tria_f, tria_s))
+    {
 
-  }
+      // As specified in the documentation for the "GridIn" class the
+      // triangulation corresponding to a grid needs to be empty at
+      // this time.
+      if (!fluid_mesh_from_checkpoint)
+        {
+          GridIn<dim> grid_in_f;
+          grid_in_f.attach_triangulation (tria_f);
+
+          ifstream file (par.fluid_mesh.c_str());
+          Assert (file, ExcFileNotOpen (par.fluid_mesh.c_str()));
+
+
+          // A grid in ucd or msh format is expected.
+          if (boost::filesystem::extension(par.fluid_mesh) == "msh")
+            grid_in_f.read_msh (file);
+          else if (boost::filesystem::extension(par.fluid_mesh) == "inp")
+            grid_in_f.read_ucd (file);
+          else
+            AssertThrow(false, ExcMessage("Input file not supported."));
+
+        }
+
+      {
+        GridIn<dim, dim> grid_in_s;
+        grid_in_s.attach_triangulation (tria_s);
+
+        ifstream file (par.solid_mesh.c_str());
+        Assert (file, ExcFileNotOpen (par.solid_mesh.c_str()));
+
+        // A grid in ucd or msh format is expected.
+        if (boost::filesystem::extension(par.solid_mesh) == "msh")
+          grid_in_s.read_msh (file);
+        else if (boost::filesystem::extension(par.solid_mesh) == "inp")
+          grid_in_s.read_ucd (file);
+        else
+          AssertThrow(false, ExcMessage("Input file not supported."));
+      }
+
+      tria_s.refine_global (par.ref_s);
+
+      if (!fluid_mesh_from_checkpoint)
+        {
+          tria_f.refine_global (par.ref_f);
+          refine_around_immersed_domain (tria_f, tria_s, fe_f, quad_s, par);
+        }
+    }
 
-  {
-    GridIn<dim, dim> grid_in_s;
-    grid_in_s.attach_triangulation (tria_s);
-
-    ifstream file (par.solid_mesh.c_str());
-    Assert (file, ExcFileNotOpen (par.solid_mesh.c_str()));
-
-    // A grid in ucd or msh format is expected.
-    if (boost::filesystem::extension(par.solid_mesh) == "msh")
-      grid_in_s.read_msh (file);
-    else if (boost::filesystem::extension(par.solid_mesh) == "inp")
-      grid_in_s.read_ucd (file);
-    else
-      AssertThrow(false, ExcMessage("Input file not supported."));
-  }
   cout
       << "Number of fluid refines = "
       << par.ref_f
       << endl;
-  tria_f.refine_global (par.ref_f);
+  if (par.adaptive_cycles_f > 0)
+    cout
+        << "Number of local fluid refinement cycles = "
+        << par.adaptive_cycles_f
+        << endl;
   cout
       << "Number of active fluid cells: "
       << tria_f.n_active_cells ()
@@ -228,7 +304,6 @@ IFEM<dim>::create_triangulation_and_dofs ()
       << "Number of solid refines = "
       << par.ref_s
       << endl;
-  tria_s.refine_global (par.ref_s);
   cout
       << "Number of active solid cells: "
       << tria_s.n_active_cells ()
@@ -250,17 +325,39 @@ IFEM<dim>::create_triangulation_and_dofs ()
 
 // Distribution of the degrees of freedom. Both for the solid
 // and fluid domains, the dofs are renumbered first globally
-// and then by component.
+// and then by component. With a setup restored from the cache, the
+// numbering is the one saved in it.
   dh_f.distribute_dofs (fe_f);
-  DoFRenumbering::boost::Cuthill_McKee (dh_f);
+  dh_s.distribute_dofs (fe_s);
 
+  vector<unsigned int> block_component (dim+1,0);
+  block_component[dim] = 1;
+
+  if (setup_cache.loaded())
+    setup_cache.renumber_dofs (dh_f, dh_s);
+  else
+    {
+      if (fluid_mesh_from_checkpoint)
+        {
+          AssertThrow (restored_numbering_f.size() == dh_f.n_dofs(),
+                       ExcMessage ("The numbering of the dofs in the checkpoint "
+                                   + restart_checkpoint
+                                   + " does not match the dofs."));
+          dh_f.renumber_dofs (restored_numbering_f);
+          vector<types::global_dof_index>().swap (restored_numbering_f);
+        }
+      else
+        {
+          renumber_dofs (dh_f, par.dof_renumbering);
 
 // Consistently with the fact that the various components of
 // the system are stored in a block matrix, now renumber
 // velocity and pressure component wise.
-  vector<unsigned int> block_component (dim+1,0);
-  block_component[dim] = 1;
-  DoFRenumbering::component_wise (dh_f, block_component);
+          DoFRenumbering::component_wise (dh_f, block_component);
+        }
+
+      renumber_dofs (dh_s, par.dof_renumbering);
+    }
 
   vector<unsigned int> dofs_per_block (2);
   DoFTools::count_dofs_per_block (dh_f, dofs_per_block, block_component);
@@ -273,15 +370,19 @@ IFEM<dim>::create_triangulation_and_dofs ()
   n_dofs_up = dh_f.n_dofs ();
 
 
-// Simply distribute dofs on the solid displacement.
-  dh_s.distribute_dofs (fe_s);
-  DoFRenumbering::boost::Cuthill_McKee (dh_s);
-
-
 // Determine the total number of dofs.
   n_dofs_W = dh_s.n_dofs ();
   n_total_dofs = n_dofs_up+n_dofs_W;
 
+// Geometric information used by the assembly and by the
+// postprocessing. It only depends on the two triangulations. If the
+// control volume is a uniform Cartesian grid, points are located in it
+// without searching.
+  fluid_geometry.initialize (dh_f);
+  solid_geometry.initialize (dh_s);
+  if (fluid_grid.initialize (dh_f))
+    cout << "The control volume is a uniform Cartesian grid." << endl;
+
   cout
       << "dim (V_h) = "
       << n_dofs_u
@@ -323,21 +424,13 @@ IFEM<dim>::create_triangulation_and_dofs ()
     constraints_f.clear ();
     constraints_s.clear ();
 
-// Enforce hanging node constraints.
+// Enforce hanging node constraints. Those of the control volume are
+// its only constraints: the boundary values are enforced through
+// <code>dense_boundary_values</code>, and adding them here would
+// remove the boundary dofs from the hanging node constraints when
+// closing <code>constraints_f</code>.
     DoFTools::make_hanging_node_constraints (dh_f, constraints_f);
     DoFTools::make_hanging_node_constraints (dh_s, constraints_s);
-
-
-// To solve the problem we first assemble the Jacobian of the residual
-// using zero boundary values for the velocity. The specification of
-// the actual boundary values is done later by the <code>apply_current_bc</code>
-// function.
-    VectorTools::interpolate_boundary_values (
-      StaticMappingQ1<dim>::mapping,
-      dh_f,
-      par.zero_boundary_map,
-      constraints_f,
-      par.component_mask);
   }
 
   //: Currently the immersed solid can have homogeneous Dirichlet boundary conditions for the CFD or FSI BM tests
@@ -347,6 +440,12 @@ IFEM<dim>::create_triangulation_and_dofs ()
     par.boundary_map_solid,
     par.boundary_values_solid
   );
+  dense_boundary_values_solid.reinit (n_dofs_W);
+  dense_boundary_values_solid.set (par.boundary_values_solid);
+  dense_boundary_values.reinit (n_dofs_up);
+
+// Boundary dofs of the control volume.
+  initialize_boundary_data ();
 
 
 
@@ -354,9 +453,18 @@ IFEM<dim>::create_triangulation_and_dofs ()
 // dof pertaining to the pressure.
   get_area_and_first_pressure_dof ();
 
+// Locate the points at which the fields are monitored.
+  initialize_probes ();
+
   constraints_f.close ();
   constraints_s.close ();
 
+// Dofs of the control volume constrained by hanging nodes.
+  hanging_dofs_f.clear ();
+  for (unsigned int i=0; i<n_dofs_up; ++i)
+    if (constraints_f.is_constrained (i))
+      hanging_dofs_f.push_back (i);
+
 
 // The following matrix plays no part in the formulation. It is
 // defined here only to use the VectorTools::project function in
@@ -396,6 +504,7 @@ IFEM<dim>::create_triangulation_and_dofs ()
             unit_pressure
           );
         }
+      constraints_f.distribute (previous_xi.block(0));
 
       if (fe_s.has_support_points())
         VectorTools::interpolate (dh_s, par.W_0, previous_xi.block(1));
@@ -406,8 +515,14 @@ IFEM<dim>::create_triangulation_and_dofs ()
   // Initialization of the current state of the system.
   current_xi = previous_xi;
 
+// The scratch objects refer to the mapping and to the finite elements,
+// and they are rebuilt the first time they are needed.
+  scratch.clear ();
+  coupling.initialize (dh_f, tmp_vec_n_dofs_up, dh_s, &fluid_grid);
+
+  mapping_displacement = previous_xi.block(1);
   mapping = std_cxx14::make_unique<MappingQEulerian<dim, Vector<double>, dim>>
-            (par.degree, dh_s, previous_xi.block(1));
+            (par.degree, dh_s, mapping_displacement);
 
   if (!par.this_is_a_restart)
     {
@@ -415,67 +530,91 @@ IFEM<dim>::create_triangulation_and_dofs ()
       output_step (0.0, previous_xi, time_step, par.dt, true);
 
       if (par.fsi_bm) fsi_bm_postprocess2();
+
+      write_probes (0.0);
     }
 
-// We now deal with the sparsity patterns.
-  {
+// We now deal with the sparsity patterns. Only the fluid and solid
+// blocks are read from the checkpoint: the coupling blocks depend on the
+// configuration of the immersed domain, and they are computed for the
+// restored one.
+  if (sparsity_from_checkpoint)
+    {
+      AssertThrow (sparsity.block(0,0).n_rows() == n_dofs_up
+                   &&
+                   sparsity.block(1,1).n_rows() == n_dofs_W,
+                   ExcMessage ("The sparsity pattern of the checkpoint does "
+                               "not match the dofs of this computation."));
 
-    BlockDynamicSparsityPattern dsp (2,2);
+      update_mapping_and_coupling (previous_xi.block(1));
 
-    dsp.block(0,0).reinit (n_dofs_up, n_dofs_up);
-    dsp.block(0,1).reinit (n_dofs_up, n_dofs_W );
-    dsp.block(1,0).reinit (n_dofs_W , n_dofs_up);
-    dsp.block(1,1).reinit (n_dofs_W , n_dofs_W );
+      if (par.jacobian_free)
+        {
+          fluid_sparsity.reinit (1, 1);
+          fluid_sparsity.block(0,0).copy_from (sparsity.block(0,0));
+          fluid_sparsity.collect_sizes ();
+        }
+      else
+        assemble_sparsity ();
+    }
+  else
+    {
+
+      BlockDynamicSparsityPattern dsp (2,2);
+
+      dsp.block(0,0).reinit (n_dofs_up, n_dofs_up);
+      dsp.block(0,1).reinit (n_dofs_up, n_dofs_W );
+      dsp.block(1,0).reinit (n_dofs_W , n_dofs_up);
+      dsp.block(1,1).reinit (n_dofs_W , n_dofs_W );
 
 
 // As stated in the documentation, now we <i>must</i> call the function
 // <code>csp.collect_sizes.()</code> since have changed the size
 // of the sub-objects of the object <code>csp</code>.
-    dsp.collect_sizes();
-
-    Table< 2, DoFTools::Coupling > coupling(dim+1,dim+1);
-    for (unsigned int i=0; i<dim; ++i)
-      {
-
-// Velocity is coupled with pressure.
-        coupling(i,dim) = DoFTools::always;
-
-// Pressure is coupled with velocity.
-        coupling(dim,i) = DoFTools::always;
-        for (unsigned int j=0; j<dim; ++j)
-
-// The velocity components are coupled with themselves and each other.
-          coupling(i,j) = DoFTools::always;
-      }
-
-// The pressure is coupled with itself.
-    coupling(dim, dim) = DoFTools::always;
+      dsp.collect_sizes();
 
+// The fluid and solid blocks only depend on the setup, and are taken
+// from the setup cache if they are there; otherwise, they are saved in
+// it along with the rest of the setup.
+      if (setup_cache.has_sparsity())
+        {
+          sparsity.copy_from (dsp);
+          sparsity.block(0,0).copy_from (setup_cache.fluid_sparsity());
+          sparsity.block(1,1).copy_from (setup_cache.solid_sparsity());
+          setup_cache.clear_sparsity ();
+        }
+      else
+        {
+          make_fluid_sparsity_pattern (dsp.block(0,0));
+          DoFTools::make_sparsity_pattern (dh_s, dsp.block(1,1));
 
-// Find the first pressure dof.  Then tell all the pressure dofs that
-// they are related to the first pressure dof.
-    if (par.all_DBC && !par.solid_is_compressible)
-      {
-        std::set<unsigned int>::iterator it = pressure_dofs.begin();
-        for (++it; it != pressure_dofs.end(); ++it)
-          {
-            dsp.block(0,0).add(constraining_dof, *it);
-          }
-      }
+          sparsity.copy_from (dsp);
 
-    DoFTools::make_sparsity_pattern (dh_f,
-                                     coupling,
-                                     dsp.block(0,0),
-                                     constraints_f,
-                                     true);
-    DoFTools::make_sparsity_pattern (dh_s, dsp.block(1,1));
+          if (setup_cache.enabled() && !setup_cache.loaded()
+              && !fluid_mesh_from_checkpoint)
+            setup_cache.save (tria_f, tria_s, dh_f, dh_s,
+                              &sparsity.block(0,0),
+                              &sparsity.block(1,1));
+        }
+      update_mapping_and_coupling (previous_xi.block(1));
 
-    sparsity.copy_from (dsp);
-    assemble_sparsity(*mapping);
-  }
+// In the Jacobian-free mode, neither the coupling blocks nor the full
+// Jacobian are ever needed, but only the fluid block.
+      if (par.jacobian_free)
+        {
+          fluid_sparsity.reinit (1, 1);
+          fluid_sparsity.block(0,0).copy_from (sparsity.block(0,0));
+          fluid_sparsity.collect_sizes ();
+        }
+      else
+        assemble_sparsity ();
+    }
 
 // Here is the Jacobian matrix.
-  JF.reinit(sparsity);
+  if (par.jacobian_free)
+    JF_fluid.reinit (fluid_sparsity);
+  else
+    JF.reinit(sparsity);
 
 
 // Boundary conditions at t = 0 (Note: If this is a restart then nothing needs to be done.)
@@ -483,7 +622,7 @@ IFEM<dim>::create_triangulation_and_dofs ()
     apply_current_bc(previous_xi, previous_time);
 
 
-  if (par.use_spread || par.fsi_bm)
+  if (par.use_spread || par.fsi_bm || par.jacobian_free)
     {
 // Resizing other containers concerning the elastic response of the
 // immersed domain.
@@ -500,31 +639,125 @@ IFEM<dim>::create_triangulation_and_dofs ()
 // Using the <code>deal.II</code> in-built functionality to
 // create the mass matrix.
       MatrixCreator::create_mass_matrix (dh_s, quad_s, M_gamma3, &phi_b_func);
-      M_gamma3_inv.initialize (M_gamma3);
+      M_gamma3_inv->initialize (M_gamma3);
+      M_gamma3_inv->print_statistics (cout, "Mass matrix of the immersed domain");
+    }
+
+// The block of the Jacobian pertaining to the displacement of the
+// immersed domain is approximated by $\Phi_{B} M / dt$, $M$ being its
+// mass matrix.
+  if (par.jacobian_free || par.finite_difference_operator)
+    jacobian_free_xit.reinit (current_xi);
+  if (par.jacobian_free)
+    {
+      fluid_res.reinit (current_xi);
+      jacobian_free_preconditioner.initialize (*JF_inv, *M_gamma3_inv, par.dt);
     }
 
   //: Determine the volume flux vector at the initial instant of time
   if (par.n_pt_source)
     {
       volume_flux.reinit(n_dofs_up);
+      initialize_point_sources ();
       get_volume_flux_vector (par.t_i);
     }
 
 }
 
 
-// Relatively standard way to determine the sparsity pattern of each
-// block of the global Jacobian.
+// Boundary dofs of the control volume and their data. Unless disabled,
+// the boundary data are sampled at a few instants of the simulation to
+// find out if they are constant or of the form g(t) u(x).
+
+template <int dim>
+void
+IFEM<dim>::initialize_boundary_data ()
+{
+  boundary_data.initialize (StaticMappingQ1<dim>::mapping,
+                            dh_f,
+                            par.boundary_map,
+                            par.component_mask,
+                            par.u_g,
+                            par.separable_bc);
+
+  cout << "Boundary dofs of the control volume: "
+       << boundary_data.n_boundary_dofs()
+       << (boundary_data.is_separable() ? " (declared separable)" : "")
+       << endl;
+}
+
+
+// Sparsity pattern of the block of the Jacobian pertaining to the
+// control volume, including the entries needed by the hanging node
+// constraints and, unless it is projected out, by the constraint on
+// the average pressure.
 
 template <int dim>
 void
-IFEM<dim>::assemble_sparsity (Mapping<dim, dim> &immersed_mapping)
+IFEM<dim>::make_fluid_sparsity_pattern (DynamicSparsityPattern &dsp)
 {
-  FEFieldFunction<dim, DoFHandler<dim>, Vector<double> > up_field (dh_f, tmp_vec_n_dofs_up);
+  dsp.reinit (n_dofs_up, n_dofs_up);
+
+  Table< 2, DoFTools::Coupling > coupling(dim+1,dim+1);
+  for (unsigned int i=0; i<dim; ++i)
+    {
+
+// Velocity is coupled with pressure.
+      coupling(i,dim) = DoFTools::always;
+
+// Pressure is coupled with velocity.
+      coupling(dim,i) = DoFTools::always;
+      for (unsigned int j=0; j<dim; ++j)
+
+// The velocity components are coupled with themselves and each other.
+        coupling(i,j) = DoFTools::always;
+    }
+
+// The pressure is coupled with itself.
+  coupling(dim, dim) = DoFTools::always;
+
+
+// Find the first pressure dof.  Then tell all the pressure dofs that
+// they are related to the first pressure dof. When the average pressure
+// is projected out, the row of the first pressure dof keeps its usual
+// sparsity.
+  if (par.all_DBC && !par.solid_is_compressible && !par.project_pressure)
+    {
+      std::set<unsigned int>::iterator it = pressure_dofs.begin();
+      for (++it; it != pressure_dofs.end(); ++it)
+        {
+          dsp.add(constraining_dof, *it);
+        }
+    }
+
+  DoFTools::make_sparsity_pattern (dh_f,
+                                   coupling,
+                                   dsp,
+                                   constraints_f,
+                                   true);
 
-  vector< typename DoFHandler<dim>::active_cell_iterator > cells;
-  vector< vector< Point< dim > > > qpoints;
-  vector< vector< unsigned int> > maps;
+// The row of a dof constrained by hanging nodes is replaced by the
+// constraint, which couples it to all of its constraining dofs, also
+// those not sharing a cell with it.
+  for (unsigned int h=0; h<hanging_dofs_f.size(); ++h)
+    {
+      const vector< pair<types::global_dof_index,double> > &entries
+        = *constraints_f.get_constraint_entries(hanging_dofs_f[h]);
+      for (unsigned int k=0; k<entries.size(); ++k)
+        dsp.add (hanging_dofs_f[h], entries[k].first);
+    }
+}
+
+
+// Relatively standard way to determine the sparsity pattern of each
+// block of the global Jacobian. The coupling blocks only depend on the
+// location of the immersed domain, which is taken from
+// <code>coupling</code>.
+
+template <int dim>
+void
+IFEM<dim>::assemble_sparsity ()
+{
   vector< unsigned int > dofs_f(fe_f.dofs_per_cell);
   vector< unsigned int > dofs_s(fe_s.dofs_per_cell);
 
@@ -532,32 +765,295 @@ IFEM<dim>::assemble_sparsity (Mapping<dim, dim> &immersed_mapping)
   cell = dh_s.begin_active(),
   endc = dh_s.end();
 
-  FEValues<dim,dim> fe_v(immersed_mapping, fe_s, quad_s,
-                         update_quadrature_points);
-
   DynamicSparsityPattern sp1(n_dofs_up, n_dofs_W);
   DynamicSparsityPattern sp2(n_dofs_W , n_dofs_up);
 
   for (; cell != endc; ++cell)
     {
-      fe_v.reinit(cell);
       cell->get_dof_indices(dofs_s);
-      up_field.compute_point_locations (fe_v.get_quadrature_points(),
-                                        cells, qpoints, maps);
+      const vector< typename DoFHandler<dim>::active_cell_iterator > &cells
+        = coupling.fluid_cells[cell->active_cell_index()];
       for (unsigned int c=0; c<cells.size(); ++c)
         {
           cells[c]->get_dof_indices(dofs_f);
           for (unsigned int i=0; i<dofs_f.size(); ++i)
-            for (unsigned int j=0; j<dofs_s.size(); ++j)
-              {
-                sp1.add(dofs_f[i],dofs_s[j]);
-                sp2.add(dofs_s[j],dofs_f[i]);
-              }
+            {
+              for (unsigned int j=0; j<dofs_s.size(); ++j)
+                {
+                  sp1.add(dofs_f[i],dofs_s[j]);
+                  sp2.add(dofs_s[j],dofs_f[i]);
+                }
+
+// The rows of the dofs constrained by hanging nodes are added to
+// the rows of the dofs constraining them.
+              if (constraints_f.is_constrained(dofs_f[i]))
+                {
+                  const vector< pair<types::global_dof_index,double> > &entries
+                    = *constraints_f.get_constraint_entries(dofs_f[i]);
+                  for (unsigned int k=0; k<entries.size(); ++k)
+                    for (unsigned int j=0; j<dofs_s.size(); ++j)
+                      sp1.add(entries[k].first,dofs_s[j]);
+                }
+            }
         }
     }
 
   sparsity.block(0,1).copy_from(sp1);
   sparsity.block(1,0).copy_from(sp2);
+
+  sparsity_coupling_stamp = coupling.n_updates;
+}
+
+
+// Set the displacement defining the configuration of the immersed
+// domain and, if it changed since the last call, find again the fluid
+// cells containing the quadrature points of the immersed domain.
+
+template <int dim>
+void
+IFEM<dim>::update_mapping_and_coupling (const Vector<double> &displacement)
+{
+  mapping_displacement = displacement;
+  if (!coupling.is_up_to_date (mapping_displacement))
+    coupling.update (*get_scratch().fe_v_s_mapped, mapping_displacement);
+}
+
+
+// Whether some quadrature points of the immersed domain, in the
+// configuration given by <code>coupling</code>, are in fluid cells coarser
+// than those of the refined region around it.
+
+template <int dim>
+bool
+IFEM<dim>::immersed_domain_left_refined_region () const
+{
+  const unsigned int finest_level = par.ref_f + par.adaptive_cycles_f;
+  for (unsigned int c=0; c<coupling.fluid_cells.size(); ++c)
+    for (unsigned int i=0; i<coupling.fluid_cells[c].size(); ++i)
+      if (static_cast<unsigned int>(coupling.fluid_cells[c][i]->level())
+          < finest_level)
+        return true;
+  return false;
+}
+
+
+// Remeshing of the control volume following the immersed domain, at
+// the end of a time step. Each of the <code>par.adaptive_cycles_f</code>
+// passes refines the fluid cells around the current position of the
+// immersed domain, and those flagged by the Kelly estimator of the
+// current velocity, by one level, and coarsens the others by one level,
+// the fluid part of the state being transferred to the new mesh. Then
+// everything that depends on the dofs of the control volume is built
+// again, as in <code>create_triangulation_and_dofs</code>. The immersed
+// domain and its dofs are not affected.
+
+template <int dim>
+void
+IFEM<dim>::remesh_fluid ()
+{
+  Timer timer;
+  const unsigned int n_cells_before = tria_f.n_active_cells();
+
+// Quadrature points of the immersed domain in its current
+// configuration.
+  mapping_displacement = previous_xi.block(1);
+  vector< Point<dim> > points;
+  {
+    FEValues<dim> fe_v_s (*mapping, fe_s, quad_s, update_quadrature_points);
+    typename DoFHandler<dim,dim>::active_cell_iterator
+    cell = dh_s.begin_active(),
+    endc = dh_s.end();
+    for (; cell != endc; ++cell)
+      {
+        fe_v_s.reinit (cell);
+        points.insert (points.end(),
+                       fe_v_s.get_quadrature_points().begin(),
+                       fe_v_s.get_quadrature_points().end());
+      }
+  }
+
+// The objects referring to the current dofs of the control volume are
+// released first.
+  scratch.clear ();
+  coupling.clear ();
+  JF.clear ();
+  JF_fluid.clear ();
+
+  const Vector<double> previous_W = previous_xi.block(1);
+  const Vector<double> current_W = current_xi.block(1);
+
+  vector<unsigned int> block_component (dim+1,0);
+  block_component[dim] = 1;
+
+  for (unsigned int pass=0; pass<par.adaptive_cycles_f; ++pass)
+    {
+      flag_cells_for_remeshing (dh_f,
+                                points,
+                                previous_xi.block(0),
+                                par.buffer_layers_f,
+                                par.kelly_fraction_f,
+                                par.ref_f,
+                                par.ref_f + par.adaptive_cycles_f);
+
+      vector< Vector<double> > fluid_state (2);
+      fluid_state[0] = previous_xi.block(0);
+      fluid_state[1] = current_xi.block(0);
+
+      SolutionTransfer<dim, Vector<double> > transfer (dh_f);
+      tria_f.prepare_coarsening_and_refinement ();
+      transfer.prepare_for_coarsening_and_refinement (fluid_state);
+      tria_f.execute_coarsening_and_refinement ();
+
+// Same numbering of the dofs as in <code>create_triangulation_and_dofs</code>.
+      dh_f.distribute_dofs (fe_f);
+      renumber_dofs (dh_f, par.dof_renumbering);
+      DoFRenumbering::component_wise (dh_f, block_component);
+
+      constraints_f.clear ();
+      DoFTools::make_hanging_node_constraints (dh_f, constraints_f);
+      constraints_f.close ();
+
+      vector< Vector<double> > new_fluid_state (2, Vector<double>(dh_f.n_dofs()));
+      transfer.interpolate (fluid_state, new_fluid_state);
+
+      vector<unsigned int> dofs_per_block (2);
+      DoFTools::count_dofs_per_block (dh_f, dofs_per_block, block_component);
+      n_dofs_u  = dofs_per_block[0];
+      n_dofs_p  = dofs_per_block[1];
+      n_dofs_up = dh_f.n_dofs ();
+      n_total_dofs = n_dofs_up+n_dofs_W;
+
+      vector<unsigned int> all_dofs (2);
+      all_dofs[0] = n_dofs_up;
+      all_dofs[1] = n_dofs_W;
+      previous_xi.reinit (all_dofs);
+      current_xi.reinit (all_dofs);
+
+      constraints_f.distribute (new_fluid_state[0]);
+      constraints_f.distribute (new_fluid_state[1]);
+      previous_xi.block(0) = new_fluid_state[0];
+      current_xi.block(0) = new_fluid_state[1];
+      previous_xi.block(1) = previous_W;
+      current_xi.block(1) = current_W;
+    }
+
+// Vectors and constraints of the new dofs, as in
+// <code>create_triangulation_and_dofs</code>.
+  vector<unsigned int> all_dofs (2);
+  all_dofs[0] = n_dofs_up;
+  all_dofs[1] = n_dofs_W;
+  current_xit.reinit (all_dofs);
+  current_res.reinit (all_dofs);
+  newton_update.reinit (all_dofs);
+
+  pressure_average.reinit (n_dofs_up);
+  unit_pressure.reinit (n_dofs_up);
+  if (fe_f.has_support_points())
+    VectorTools::interpolate (dh_f,
+                              ComponentSelectFunction<dim>(dim, 1., dim+1),
+                              unit_pressure);
+  else
+    {
+      ConstraintMatrix cc;
+      cc.close();
+      VectorTools::project (dh_f,
+                            cc,
+                            quad_f,
+                            ComponentSelectFunction<dim>(dim, 1., dim+1),
+                            unit_pressure);
+    }
+
+  tmp_vec_n_total_dofs.reinit (n_total_dofs);
+  tmp_vec_n_dofs_up.reinit (n_dofs_up);
+
+  hanging_dofs_f.clear ();
+  for (unsigned int i=0; i<n_dofs_up; ++i)
+    if (constraints_f.is_constrained (i))
+      hanging_dofs_f.push_back (i);
+
+  fluid_geometry.initialize (dh_f);
+  fluid_grid.initialize (dh_f);
+  dense_boundary_values.reinit (n_dofs_up);
+  initialize_boundary_data ();
+  get_area_and_first_pressure_dof ();
+  initialize_probes ();
+
+// The coupling with the immersed domain and the sparsity pattern.
+  coupling.initialize (dh_f, tmp_vec_n_dofs_up, dh_s, &fluid_grid);
+  {
+    DynamicSparsityPattern dsp;
+    make_fluid_sparsity_pattern (dsp);
+    sparsity.block(0,0).copy_from (dsp);
+  }
+  update_mapping_and_coupling (previous_xi.block(1));
+
+// As in <code>create_triangulation_and_dofs()</code>, the coupling
+// blocks are left empty in the Jacobian-free mode; they only need the
+// new number of rows and columns.
+  if (par.jacobian_free)
+    {
+      sparsity.block(0,1).copy_from (DynamicSparsityPattern (n_dofs_up, n_dofs_W));
+      sparsity.block(1,0).copy_from (DynamicSparsityPattern (n_dofs_W, n_dofs_up));
+    }
+  else
+    assemble_sparsity ();
+  sparsity.collect_sizes ();
+
+  if (par.jacobian_free)
+    {
+      fluid_sparsity.block(0,0).copy_from (sparsity.block(0,0));
+      fluid_sparsity.collect_sizes ();
+      JF_fluid.reinit (fluid_sparsity);
+      jacobian_free_xit.reinit (current_xi);
+      fluid_res.reinit (current_xi);
+    }
+  else
+    {
+      JF.reinit (sparsity);
+      if (par.finite_difference_operator)
+        jacobian_free_xit.reinit (current_xi);
+    }
+
+  if (par.n_pt_source)
+    {
+      volume_flux.reinit (n_dofs_up);
+      initialize_point_sources ();
+      get_volume_flux_vector (current_time);
+    }
+
+// The factorization of the Jacobian refers to the old dofs.
+  newton_policy.discard_jacobian ();
+
+  cout
+      << " Remeshed the control volume: "
+      << n_cells_before
+      << " -> "
+      << tria_f.n_active_cells()
+      << " cells, "
+      << n_dofs_up
+      << " dofs (in "
+      << timer.wall_time()
+      << " s)"
+      << endl;
+}
+
+
+// Access to the scratch objects of the current thread, which are built
+// the first time they are requested.
+
+template <int dim>
+AssemblyScratch<dim> &
+IFEM<dim>::get_scratch ()
+{
+  AssemblyScratch<dim> &scratch_data = scratch.get();
+  if (!scratch_data.initialized)
+    scratch_data.reinit (fe_f,
+                         fe_s,
+                         quad_f,
+                         quad_s,
+                         *mapping,
+                         !par.semi_implicit);
+  return scratch_data;
 }
 
 // Determination of the volume (area in 2D) of the control volume and
@@ -567,23 +1063,18 @@ template <int dim>
 void
 IFEM<dim>::get_area_and_first_pressure_dof ()
 {
-  area = 0.0;
+// The area of the control volume is known from the geometry cache.
+  area = fluid_geometry.measure;
+
   typename DoFHandler<dim,dim>::active_cell_iterator
   cell = dh_f.begin_active (),
   endc = dh_f.end ();
 
-  FEValues<dim,dim> fe_v (fe_f,
-                          quad_f,
-                          update_values |
-                          update_JxW_values);
-
   vector<unsigned int> dofs_f(fe_f.dofs_per_cell);
 
-
-// Calculate the area of the control volume.
+  pressure_dofs.clear ();
   for (; cell != endc; ++cell)
     {
-      fe_v.reinit (cell);
       cell->get_dof_indices (dofs_f);
 
       for (unsigned int i=0; i < fe_f.dofs_per_cell; ++i)
@@ -595,15 +1086,62 @@ IFEM<dim>::get_area_and_first_pressure_dof ()
               if (dgp_for_p) break;
             }
         }
+    }
 
-      for (unsigned int q=0; q<quad_f.size(); ++q) area += fe_v.JxW(q);
 
-    }
+// Get the first dof pertaining to pressure which is not constrained by
+// hanging nodes.
+  std::set<unsigned int>::const_iterator first = pressure_dofs.begin();
+  while (constraints_f.is_constrained (*first))
+    ++first;
+  constraining_dof = *first;
+
+// The weights giving the average pressure are only needed when the
+// latter is projected out. They are the integrals of the shape
+// functions of the pressure dofs, with the same choice of dofs as in
+// <code>residual_and_or_Jacobian</code>.
+  pressure_weights.reinit (0);
+  if (!(par.all_DBC && !par.fix_pressure && !par.solid_is_compressible
+        && par.project_pressure))
+    return;
 
+  pressure_weights.reinit (dh_f.n_dofs());
 
-// Get the first dof pertaining to pressure.
-  constraining_dof = *(pressure_dofs.begin());
+  FEValues<dim> fe_f_v (fe_f, quad_f, update_values | update_JxW_values);
 
+  for (cell = dh_f.begin_active (); cell != endc; ++cell)
+    {
+      fe_f_v.reinit (cell);
+      cell->get_dof_indices (dofs_f);
+
+      for (unsigned int i=0; i < fe_f.dofs_per_cell; ++i)
+        if (fe_f.system_to_component_index(i).first == dim
+            &&
+            (!dgp_for_p || (fe_f.system_to_component_index(i).second==0)))
+          for (unsigned int q=0; q<quad_f.size(); ++q)
+            pressure_weights(dofs_f[i]) += fe_f_v.shape_value(i,q)
+                                           *fe_f_v.JxW(q);
+    }
+}
+
+// Removal of the average from the pressure in the vector
+// <code>up</code> of the control volume. Since the pressure is only
+// determined up to a constant, this does not change the residual of
+// any equation other than the one of the constraining dof, which is
+// the average pressure itself.
+
+template <int dim>
+void
+IFEM<dim>::remove_average_pressure (Vector<double> &up) const
+{
+  double average_pressure = 0;
+  std::set<unsigned int>::const_iterator it = pressure_dofs.begin();
+  for (; it != pressure_dofs.end(); ++it)
+    average_pressure += pressure_weights(*it) * up(*it);
+  average_pressure /= area;
+
+  for (it = pressure_dofs.begin(); it != pressure_dofs.end(); ++it)
+    up(*it) -= average_pressure;
 }
 
 
@@ -619,7 +1157,8 @@ IFEM<dim>::residual_and_or_Jacobian
   const BlockVector<double> &xit,
   const BlockVector<double> &xi,
   const double alpha,
-  const double t
+  const double t,
+  const bool fluid_only
 )
 {
 
@@ -627,29 +1166,44 @@ IFEM<dim>::residual_and_or_Jacobian
   bool update_jacobian = !jacobian.empty();
 
 
+// All the temporary objects used below are taken from the scratch
+// storage of the current thread.
+  AssemblyScratch<dim> &scratch_data = get_scratch();
+
+
 // In a semi-implicit scheme, the position of the immersed body
 // coincides with the position of the body at the previous time step.
+// The location of the immersed body in the control volume is only
+// recomputed if the position has changed since the last call.
   if (par.semi_implicit == true)
-    mapping = std_cxx14::make_unique<MappingQEulerian<dim, Vector<double>, dim> >
-              (par.degree, dh_s, previous_xi.block(1));
+    update_mapping_and_coupling (previous_xi.block(1));
   else
-    mapping = std_cxx14::make_unique<MappingQEulerian<dim, Vector<double>, dim> >
-              (par.degree, dh_s, xi.block(1));
+    update_mapping_and_coupling (xi.block(1));
 
 
 // In applying the boundary conditions, we set a scaling factor equal
 // to the diameter of the smallest cell in the triangulation of the fluid .
-  scaling = GridTools::minimal_cell_diameter(tria_f);
+  scaling = fluid_geometry.min_diameter;
 
 // Initialization of the residual.
   residual = 0;
 
-// If the Jacobian is needed, then it is initialized here.
+// If the Jacobian is needed, then it is initialized here. The sparsity
+// pattern is rebuilt only if the immersed domain moved since it was
+// last computed. If only the fluid block is requested, the coupling
+// blocks are not needed.
   if (update_jacobian)
     {
-      jacobian.clear();
-      assemble_sparsity(*mapping);
-      jacobian.reinit(sparsity);
+      if (fluid_only)
+        jacobian = 0;
+      else if (sparsity_coupling_stamp != coupling.n_updates)
+        {
+          jacobian.clear();
+          assemble_sparsity();
+          jacobian.reinit(sparsity);
+        }
+      else
+        jacobian = 0;
     }
 
 
@@ -657,7 +1211,9 @@ IFEM<dim>::residual_and_or_Jacobian
   if (par.n_pt_source)
     {
       get_volume_flux_vector (t);
-      residual.block(0) += volume_flux;
+      const vector<unsigned int> &source_dofs = point_sources.dofs();
+      for (unsigned int i=0; i<source_dofs.size(); ++i)
+        residual.block(0)(source_dofs[i]) += volume_flux(source_dofs[i]);
     }
 
 
@@ -679,17 +1235,12 @@ IFEM<dim>::residual_and_or_Jacobian
 
 
 // Storage for the local dofs in the fluid and in the solid.
-  vector< unsigned int > dofs_f(fe_f.dofs_per_cell);
-  vector< unsigned int > dofs_s(fe_s.dofs_per_cell);
+  vector< unsigned int > &dofs_f = scratch_data.dofs_f;
+  vector< unsigned int > &dofs_s = scratch_data.dofs_s;
 
 
 // <code>FEValues</code> for the fluid.
-  FEValues<dim> fe_f_v (fe_f,
-                        quad_f,
-                        update_values |
-                        update_gradients |
-                        update_JxW_values |
-                        update_quadrature_points);
+  FEValues<dim> &fe_f_v = *scratch_data.fe_f_v;
 
 
 // Number of quadrature points on fluid and solid cells.
@@ -698,11 +1249,17 @@ IFEM<dim>::residual_and_or_Jacobian
 
 
 // The local residual vector: the largest possible size of this
-// vector is <code>n_local_dofs</code>.
-  vector<double> local_res(n_local_dofs);
-  vector<Vector<double> > local_force(nqpf, Vector<double>(dim+1));
-  FullMatrix<double> local_jacobian;
-  if (update_jacobian) local_jacobian.reinit(n_local_dofs, n_local_dofs);
+// vector is <code>n_local_dofs</code>. The local Jacobian is left empty
+// when the Jacobian is not needed.
+  Assert (scratch_data.local_res.size() == n_local_dofs,
+          ExcDimensionMismatch (scratch_data.local_res.size(), n_local_dofs));
+  vector<double> &local_res = scratch_data.local_res;
+  vector<Vector<double> > &local_force = scratch_data.local_force_f;
+  FullMatrix<double> &local_jacobian = (update_jacobian
+                                        ?
+                                        scratch_data.local_jacobian
+                                        :
+                                        scratch_data.no_jacobian);
 
 
 // Since we want to solve a system of equations of the form
@@ -726,15 +1283,13 @@ IFEM<dim>::residual_and_or_Jacobian
 //      <code>local_x</code>.
 // <ul>
 
-// Definition of the local dependent variables for the fluid.
-  vector<Vector<double> > local_upt(nqpf, Vector<double>(dim+1));
-  vector<Vector<double> > local_up (nqpf, Vector<double>(dim+1));
-  vector< vector< Tensor<1,dim> > > local_grad_up(
-    nqpf,
-    vector< Tensor<1,dim> >(dim+1)
-  );
-  vector< vector< Tensor<1,dim> > > local_grad_upt;
-  vector< vector< Tensor<2,dim> > > local_hessian_up;
+// Definition of the local dependent variables for the fluid. They are
+// large enough for the quadrature points of both a fluid and a solid cell.
+  vector<Vector<double> > &local_upt = scratch_data.local_upt;
+  vector<Vector<double> > &local_up  = scratch_data.local_up;
+  vector< vector< Tensor<1,dim> > > &local_grad_up = scratch_data.local_grad_up;
+  vector< vector< Tensor<1,dim> > > &local_grad_upt = scratch_data.local_grad_upt;
+  vector< vector< Tensor<2,dim> > > &local_hessian_up = scratch_data.local_hessian_up;
   unsigned int comp_i = 0, comp_j = 0;
 
 // Initialization of the constants used for compensation of the Lagrange multiplier over the region occupied by the compressible solid:
@@ -748,7 +1303,7 @@ IFEM<dim>::residual_and_or_Jacobian
 // Initialization of the local contribution to the pressure
 // average.
   double local_average_pressure = 0.0;
-  vector<double> local_pressure_coefficient(n_local_dofs);
+  vector<double> &local_pressure_coefficient = scratch_data.local_pressure_coefficient;
 
 
 // ------------------------------------------------------------
@@ -782,18 +1337,21 @@ IFEM<dim>::residual_and_or_Jacobian
 // at the quadrature points on the current fluid cell.  Strictly
 // speaking, this vector also includes values of the partial
 // derivative of the pressure with respect to time.
-      fe_f_v.get_function_values(xit.block(0), local_upt);
+      get_local_function_values (fe_f_v, fe_f, dofs_f, xit.block(0),
+                                 nqpf, local_upt);
 
 
 // Values of the velocity at the quadrature points on the current
 // fluid cell. Strictly speaking, this vector also includes values of
 // pressure.
-      fe_f_v.get_function_values(xi.block(0), local_up);
+      get_local_function_values (fe_f_v, fe_f, dofs_f, xi.block(0),
+                                 nqpf, local_up);
 
 
 // Values of the gradient of the velocity at the quadrature points of
 // the current fluid cell.
-      fe_f_v.get_function_gradients(xi.block(0), local_grad_up);
+      get_local_function_gradients (fe_f_v, fe_f, dofs_f, xi.block(0),
+                                    nqpf, local_grad_up);
 
 
 // Values of the body force at the quadrature points of the current
@@ -958,7 +1516,7 @@ IFEM<dim>::residual_and_or_Jacobian
 // is assembled into the global system's residual.
       distribute_residual(residual.block(0), local_res, dofs_f, 0);
       if (update_jacobian)
-        distribute_jacobian (JF.block(0,0),
+        distribute_jacobian (jacobian.block(0,0),
                              local_jacobian,
                              dofs_f,
                              dofs_f,
@@ -979,8 +1537,9 @@ IFEM<dim>::residual_and_or_Jacobian
     }
 
   //: SR--- For NS component only, we now just return :)
-  if (par.only_NS)
+  if (par.only_NS || fluid_only)
     {
+      apply_hanging_node_constraints (residual, jacobian, xi.block(0));
       return;
       cout<<" We have returned right?"<<endl;
     }
@@ -1013,19 +1572,13 @@ IFEM<dim>::residual_and_or_Jacobian
 
 
 
-// Representation of the velocity and pressure in the control volume
-// as a field.
-  FEFieldFunction<dim, DoFHandler<dim>, Vector<double> >
-  up_field (dh_f, xi.block(0));
+// Values of the body force at the quadrature points of a solid cell.
+  vector<Vector<double> > &local_force_s = scratch_data.local_force_s;
 
 
-// Containers to store the information on the interaction of the
-// current solid cell with the corresponding set of fluid cells that
-// happen to contain the quadrature points of the solid cell in
-// question.
-  vector< typename DoFHandler<dim>::active_cell_iterator > fluid_cells;
-  vector< vector< Point< dim > > > fluid_qpoints;
-  vector< vector< unsigned int> > fluid_maps;
+// Values and derivatives of the fluid shape functions at the quadrature
+// points of a solid cell falling in a given fluid cell.
+  PointShapeValues<dim> &local_fe_f_v = scratch_data.local_fe_f_v;
 
 
 // Local storage of the
@@ -1042,26 +1595,21 @@ IFEM<dim>::residual_and_or_Jacobian
 //  <li> Frechet derivative of $P_{s}^{e} F^{T}$ with respect to degrees of
 //    freedom in a solid cell: <code>DPeFT_dxi</code>.
 // </ul>
-  vector<Vector<double> > local_Wt(nqps, Vector<double>(dim));
-  vector<Vector<double> > local_W (nqps, Vector<double>(dim));
-  vector<Tensor<2,dim,double> > Pe(nqps, Tensor<2,dim,double>());
-  vector<Tensor<2,dim,double> > F(nqps, Tensor<2,dim,double>());
-  vector<double> local_J(nqps);
-  vector<Tensor<2,dim,double> > local_invFT(nqps, Tensor<2,dim,double>());
+  vector<Vector<double> > &local_Wt = scratch_data.local_Wt;
+  vector<Vector<double> > &local_W  = scratch_data.local_W;
+  vector<Tensor<2,dim,double> > &Pe = scratch_data.Pe;
+  vector<Tensor<2,dim,double> > &F  = scratch_data.F;
+  vector<double> &local_J = scratch_data.local_J;
+  vector<Tensor<2,dim,double> > &local_invFT = scratch_data.local_invFT;
   Tensor<2,dim,double> PeFT;
-  vector< vector<Tensor<2,dim,double> > > DPeFT_dxi;
-  if (update_jacobian)
-    {
-      DPeFT_dxi.resize(nqps, vector< Tensor<2,dim,double> >
-                       (fe_s.dofs_per_cell, Tensor<2,dim,double>()));
-    }
+  vector< vector<Tensor<2,dim,double> > > &DPeFT_dxi = scratch_data.DPeFT_dxi;
 
   //SR: If the solid is compressible then we also need to store the following:
   // <ul>
   // <li> divergence of the velocity
   // <li> the mean elastic stress in the solis
   // </ul>
-  vector<double> local_div_u;
+  vector<double> &local_div_u = scratch_data.local_div_u;
 
 
 // Initialization of the elastic operator of the immersed
@@ -1070,29 +1618,16 @@ IFEM<dim>::residual_and_or_Jacobian
 
 // Definition of the local contributions to $A_{\gamma}$ and the product of
 // the inverse of the mass matrix of the immersed domain with $A_{\gamma}$.
-  Vector<double> local_A_gamma;
-  Vector<double> local_M_gamma3_inv_A_gamma;
-  if (par.use_spread)
-    {
-      local_A_gamma.reinit(fe_s.dofs_per_cell);
-      local_M_gamma3_inv_A_gamma.reinit(fe_s.dofs_per_cell);
-    }
+  Vector<double> &local_A_gamma = scratch_data.local_A_gamma;
+  Vector<double> &local_M_gamma3_inv_A_gamma = scratch_data.local_M_gamma3_inv_A_gamma;
 
-// This information is used in finding what fluid cell contain the
-// solid domain at the current time.
-  FEValues<dim,dim> fe_v_s_mapped (*mapping,
-                                   fe_s,
-                                   quad_s,
-                                   update_quadrature_points);
+// This information is used to evaluate the body force at the current
+// position of the quadrature points of the solid.
+  FEValues<dim,dim> &fe_v_s_mapped = *scratch_data.fe_v_s_mapped;
 
 
 // <code>FEValues</code> to carry out integrations over the solid domain.
-  FEValues<dim,dim> fe_v_s(fe_s,
-                           quad_s,
-                           update_quadrature_points |
-                           update_values |
-                           update_gradients |
-                           update_JxW_values);
+  FEValues<dim,dim> &fe_v_s = *scratch_data.fe_v_s;
 
 
 // Iterators pointing to the beginning and end cells
@@ -1109,12 +1644,13 @@ IFEM<dim>::residual_and_or_Jacobian
         {
           fe_v_s.reinit (cell_s);
           cell_s->get_dof_indices (dofs_s);
-          get_Agamma_values (fe_v_s, dofs_s, xi.block(1), local_A_gamma);
+          get_Agamma_values (fe_v_s, dofs_s, xi.block(1), local_A_gamma,
+                             scratch_data);
           A_gamma.add (dofs_s, local_A_gamma);
         }
 
       M_gamma3_inv_A_gamma = A_gamma;
-      M_gamma3_inv.solve (M_gamma3_inv_A_gamma);
+      M_gamma3_inv->solve (M_gamma3_inv_A_gamma);
     }
 
 // -----------------------------------------------
@@ -1129,8 +1665,10 @@ IFEM<dim>::residual_and_or_Jacobian
 
 // Localization of the current independent variables for the immersed
 // domain.
-      fe_v_s.get_function_values (xit.block(1), local_Wt);
-      fe_v_s.get_function_values ( xi.block(1), local_W);
+      get_local_function_values (fe_v_s, fe_s, dofs_s, xit.block(1),
+                                 nqps, local_Wt);
+      get_local_function_values (fe_v_s, fe_s, dofs_s, xi.block(1),
+                                 nqps, local_W);
       if (par.use_spread)
         localize (local_M_gamma3_inv_A_gamma, M_gamma3_inv_A_gamma, dofs_s);
       get_Pe_F_and_DPeFT_dxi_values (fe_v_s,
@@ -1139,7 +1677,8 @@ IFEM<dim>::residual_and_or_Jacobian
                                      update_jacobian,
                                      Pe,
                                      F,
-                                     DPeFT_dxi);
+                                     DPeFT_dxi,
+                                     scratch_data.H);
 
       get_inverse_transpose(F, local_invFT);
 
@@ -1149,17 +1688,19 @@ IFEM<dim>::residual_and_or_Jacobian
       for (unsigned int qt = 0; qt < nqps; ++qt)
         local_J [qt] = determinant(F[qt]);
 
-// Coupling between fluid and solid.  Identification of the fluid
-// cells containing the quadrature points on the current solid cell.
-      up_field.compute_point_locations (fe_v_s_mapped.get_quadrature_points(),
-                                        fluid_cells,
-                                        fluid_qpoints,
-                                        fluid_maps);
+// Coupling between fluid and solid.  The fluid cells containing the
+// quadrature points on the current solid cell have already been
+// identified.
+      const unsigned int cell_index = cell_s->active_cell_index();
+      const vector< typename DoFHandler<dim>::active_cell_iterator > &fluid_cells
+        = coupling.fluid_cells[cell_index];
+      const vector< vector< Point< dim > > > &fluid_qpoints
+        = coupling.fluid_qpoints[cell_index];
+      const vector< vector< unsigned int> > &fluid_maps
+        = coupling.fluid_maps[cell_index];
 
-      set_to_zero(local_force);
-      local_force.resize (nqps, Vector<double>(dim+1));
       par.force.vector_value_list (fe_v_s_mapped.get_quadrature_points(),
-                                   local_force);
+                                   local_force_s);
 
 // Cycle over all of the fluid cells that happen to contain some of
 // the the quadrature points of the current solid cell.
@@ -1168,62 +1709,46 @@ IFEM<dim>::residual_and_or_Jacobian
           fluid_cells[c]->get_dof_indices (dofs_f);
 
 
-          // Local <code>FEValues</code> of the fluid
-          Quadrature<dim> local_quad (fluid_qpoints[c]);
-          FEValues<dim> local_fe_f_v (fe_f,
-                                      local_quad,
-                                      update_values |
-                                      update_gradients |
-                                      update_hessians);
-          local_fe_f_v.reinit(fluid_cells[c]);
+          // Values and derivatives of the fluid shape functions at
+          // the quadrature points of the solid that fall in the current
+          // fluid cell.
+          local_fe_f_v.reinit(fluid_cells[c], fluid_qpoints[c]);
+          const unsigned int n_local_q = local_fe_f_v.n_quadrature_points;
 
 
           // Construction of the values at the quadrature points of the current
           // solid cell of the velocity of the fluid.
-          set_to_zero(local_up);
-          local_up.resize (local_quad.size(), Vector<double>(dim+1));
-          local_fe_f_v.get_function_values (xi.block(0), local_up);
+          get_local_function_values (local_fe_f_v, fe_f, dofs_f, xi.block(0),
+                                     n_local_q, local_up);
 
-          set_to_zero(local_upt);
-          local_upt.resize (local_quad.size(), Vector<double>(dim+1));
-          local_fe_f_v.get_function_values (xit.block(0), local_upt);
+          get_local_function_values (local_fe_f_v, fe_f, dofs_f, xit.block(0),
+                                     n_local_q, local_upt);
 
 
           // Construction of the values at the quadrature points of the current
           // solid cell of the gradient of velocity of the fluid.
-          set_to_zero(local_grad_up);
-          local_grad_up.resize (local_quad.size(),
-                                vector< Tensor<1,dim> >(dim+1)
-                               );
-          local_fe_f_v.get_function_gradients (xi.block(0), local_grad_up);
+          get_local_function_gradients (local_fe_f_v, fe_f, dofs_f, xi.block(0),
+                                        n_local_q, local_grad_up);
 
           if (!par.semi_implicit)
             {
-              set_to_zero(local_grad_upt);
-              local_grad_upt.resize (local_quad.size(),
-                                     vector< Tensor<1,dim> > (dim+1)
-                                    );
-              local_fe_f_v.get_function_gradients (xit.block(0), local_grad_upt);
-
-
-              set_to_zero(local_hessian_up);
-              local_hessian_up.resize (local_quad.size(),
-                                       vector< Tensor<2,dim> > (dim+1)
-                                      );
-              local_fe_f_v.get_function_hessians (xi.block(0), local_hessian_up);
-
+              get_local_function_gradients (local_fe_f_v, fe_f, dofs_f, xit.block(0),
+                                            n_local_q, local_grad_upt);
 
+              get_local_function_hessians (local_fe_f_v, fe_f, dofs_f, xi.block(0),
+                                           n_local_q, local_hessian_up);
             }
 
 
           // Construction of the values at the quadrature points of the current
           // solid cell of the divergence of velocity of the fluid.
           // Note that this is required only when the solid is compressible
-          set_to_zero(local_div_u);
-          local_div_u.resize(local_quad.size());
-          for (unsigned int qt = 0; qt < local_quad.size(); ++qt)
-            for (unsigned int k= 0; k < dim; ++k)
-              local_div_u[qt] += local_grad_up[qt][k][k];
+          for (unsigned int qt = 0; qt < n_local_q; ++qt)
+            {
+              local_div_u[qt] = 0;
+              for (unsigned int k= 0; k < dim; ++k)
+                local_div_u[qt] += local_grad_up[qt][k][k];
+            }
 
           // A bit of nomenclature:
           // <dl>
@@ -1245,10 +1770,10 @@ IFEM<dim>::residual_and_or_Jacobian
 
           // Equation in $V'$: begin cycle over the quadrature points of the
           // solid cell that happen to be in this fluid cell
-          for (unsigned int q=0; q<local_quad.size(); ++q)
+          for (unsigned int q=0; q<n_local_q; ++q)
             {
               // Quadrature point on the <i>mapped</i> solid ($B_{t}$).
-              unsigned int &qs = fluid_maps[c][q];
+              const unsigned int qs = fluid_maps[c][q];
 
 
               if ((!par.semi_implicit) || (!par.use_spread) || par.solid_is_compressible)
@@ -1340,11 +1865,11 @@ IFEM<dim>::residual_and_or_Jacobian
                       // $ [( \rho_{s} - J \rho_f) (\partial u/\partial t) - b ) +  \rho_{s} (\nabla_{x} u ) \partial w/\partial t - \rho_{f} (\nabla_{x} u) u ] \cdot v
                       local_res[i] +=  (par.rho_s
                                         *(local_upt[q](comp_i)
-                                          - local_force[qs](comp_i))
+                                          - local_force_s[qs](comp_i))
                                         - local_J[qs]
                                         * par.rho_f
                                         * (local_upt[q](comp_i)
-                                           - local_force[qs](comp_i)
+                                           - local_force_s[qs](comp_i)
                                            * (par.csm_test ? 0.0: 1.0))
                                        )
                                        *local_fe_f_v.shape_value(i,q)
@@ -1426,7 +1951,7 @@ IFEM<dim>::residual_and_or_Jacobian
                                                          * (local_invFT[qs][comp_j]
                                                             * fe_v_s.shape_grad(j, qs))
                                                          * (local_upt[q](comp_i)
-                                                            - local_force[qs](comp_i)
+                                                            - local_force_s[qs](comp_i)
                                                             * (par.csm_test ? 0.0: 1.0))
                                                        )*local_fe_f_v.shape_value(i, q);
 
@@ -1465,7 +1990,7 @@ IFEM<dim>::residual_and_or_Jacobian
                                                           * ( local_grad_upt[q][comp_i][comp_j]
                                                               * local_fe_f_v.shape_value(i, q)
                                                               + ( local_upt[q](comp_i)
-                                                                  - local_force[qs](comp_i))
+                                                                  - local_force_s[qs](comp_i))
                                                               * local_fe_f_v.shape_grad(i, q)[comp_j])
                                                           * fe_v_s.shape_value(j, qs);
 
@@ -1831,9 +2356,9 @@ IFEM<dim>::residual_and_or_Jacobian
             {
               unsigned int wi = i + fe_f.dofs_per_cell;
               comp_i = fe_s.system_to_component_index(i).first;
-              for (unsigned int q=0; q<local_quad.size(); ++q)
+              for (unsigned int q=0; q<n_local_q; ++q)
                 {
-                  unsigned int &qs = fluid_maps[c][q];
+                  const unsigned int qs = fluid_maps[c][q];
 
                   // $- u(x,t)\big|_{x = s + w(s,t)} \cdot y(s)$.
                   local_res[wi] -= par.Phi_B
@@ -1971,8 +2496,118 @@ IFEM<dim>::residual_and_or_Jacobian
 // -----------------------------------------------
 // OPERATORS DEFINED OVER THE IMMERSED DOMAIN: END
 // -----------------------------------------------
+
+  apply_hanging_node_constraints (residual, jacobian, xi.block(0));
+}
+
+// Factorization of the current Jacobian, which is used to compute the
+// Newton updates, or to precondition their computation.
+
+template <int dim>
+void
+IFEM<dim>::factorize_jacobian ()
+{
+  set_factorization_ordering ();
+
+  if (par.jacobian_free)
+    JF_inv->initialize (JF_fluid.block(0,0));
+  else if (par.only_NS)
+    JF_inv->initialize (JF.block(0,0)); //: SR Inverse of the Jacobian of the (0,0) block only
+  else
+    JF_inv->initialize (JF);//: Inverse of the Jacobian of the entire system
+
+  if (JF_inv->statistics().n_factorizations == 1)
+    JF_inv->print_statistics (cout, "First factorization of the Jacobian");
+
+  newton_policy.jacobian_refreshed ();
+}
+
+
+// Column ordering used by the factorization of the Jacobian. The block
+// interleaved, cell-local and joint orderings are computed here, the
+// last one every time, since the coupling between fluid and solid dofs
+// changes as the immersed domain moves. When only the fluid block is factorized,
+// there is nothing to join, and the solver chooses the ordering.
+
+template <int dim>
+void
+IFEM<dim>::set_factorization_ordering ()
+{
+  const bool full_system = !(par.only_NS || par.jacobian_free);
+  const DirectSolver::Ordering ordering
+    = direct_solver_ordering (par.factorization_ordering);
+
+  if (ordering != DirectSolver::given)
+    JF_inv->set_ordering (ordering);
+  else if (par.factorization_ordering == "Block interleaved")
+    {
+      block_interleaved_ordering (n_dofs_u,
+                                  n_dofs_p,
+                                  (full_system ? n_dofs_W : 0),
+                                  factorization_columns);
+      JF_inv->set_ordering (DirectSolver::given, factorization_columns);
+    }
+  else if (par.factorization_ordering == "Cell-local pressure")
+    {
+      AssertThrow (dgp_for_p,
+                   ExcMessage ("The cell-local pressure ordering needs "
+                               "a discontinuous pressure (FE_DGP)."));
+      cell_local_pressure_ordering (dh_f,
+                                    (full_system ? n_dofs_W : 0),
+                                    factorization_columns);
+      JF_inv->set_ordering (DirectSolver::given, factorization_columns);
+    }
+  else if (full_system)
+    {
+      joint_fluid_solid_ordering (n_dofs_up,
+                                  sparsity.block(1,0),
+                                  factorization_columns);
+      JF_inv->set_ordering (DirectSolver::given, factorization_columns);
+    }
+  else
+    JF_inv->set_ordering (DirectSolver::automatic);
+}
+
+
+// Residual at the state <code>xi</code>, the time derivative being given by
+// the implicit Euler method. This is the function differentiated by
+// <code>fd_jacobian</code>.
+
+template <int dim>
+void
+IFEM<dim>::evaluate_residual (const BlockVector<double> &xi,
+                              const double t,
+                              BlockVector<double> &residual)
+{
+  time_derivative (xi, previous_xi, par.dt, jacobian_free_xit);
+
+  residual_and_or_Jacobian (residual,
+                            dummy_JF,
+                            jacobian_free_xit,
+                            xi,
+                            0,
+                            t);
+}
+
+
+// Jacobian of the equations of the control volume, without the
+// contribution of the immersed domain, at the current state. The
+// residual computed along with it is incomplete and not used.
+
+template <int dim>
+void
+IFEM<dim>::assemble_fluid_jacobian (const double t)
+{
+  residual_and_or_Jacobian (fluid_res,
+                            JF_fluid,
+                            current_xit,
+                            current_xi,
+                            1./par.dt,
+                            t,
+                            true);
 }
 
+
 // Central management of the time stepping scheme.
 
 template <int dim>
@@ -1983,9 +2618,33 @@ IFEM<dim>::run ()
 
   const double TOLF = (par.fsi_bm? 1e-8 : 1e-10);
 
-// The variable <code>update_Jacobian</code> is set to true so to have a
-// meaningful first update of the solution.
-  bool update_Jacobian = true;
+// The policy always requests a Jacobian at the first iteration, so to
+// have a meaningful first update of the solution.
+  if (par.adaptive_jacobian_refresh)
+    newton_policy.initialize (NewtonPolicy::contraction,
+                              par.newton_absolute_tolerance,
+                              par.newton_relative_tolerance,
+                              par.jacobian_refresh_contraction,
+                              par.max_newton_iterations,
+                              par.update_jacobian_continuously,
+                              par.update_jacobian_at_step_beginning);
+  else
+    newton_policy.initialize (NewtonPolicy::legacy,
+                              TOLF,
+                              0.0,
+                              1.0,
+                              0,
+                              par.update_jacobian_continuously,
+                              par.update_jacobian_at_step_beginning);
+
+  forcing_term.initialize ((par.eisenstat_walker ?
+                            ForcingTerm::eisenstat_walker :
+                            ForcingTerm::constant),
+                           par.initial_forcing_term,
+                           par.max_forcing_term,
+                           (par.adaptive_jacobian_refresh ?
+                            par.newton_absolute_tolerance :
+                            TOLF));
 
 // The overall cycle over time begins here.
   for (double t = current_time + par.dt; (t - par.T) <= 1e-8; t += par.dt)
@@ -2007,10 +2666,10 @@ IFEM<dim>::run ()
       current_time = t;
       ++time_step;
 
-// Initialization of two counters for monitoring the progress of the
+// Initialization of the counters monitoring the progress of the
 // nonlinear solver.
-      unsigned int       nonlin_iter = 0;
-      unsigned int outer_nonlin_iter = 0;
+      newton_policy.begin_step ();
+      forcing_term.begin_step ();
 
 //Impose the Dirichlet boundary conditions pertaining to the current time
 // on the state of the system
@@ -2032,11 +2691,21 @@ IFEM<dim>::run ()
 
 
 // Time derivative of the system's state.
-          current_xit  = current_xi;
-          current_xit -= previous_xi;
-          current_xit /= par.dt;
-
-          if (update_Jacobian == true)
+          time_derivative (current_xi, previous_xi, par.dt, current_xit);
+
+// With an iterative linear solver and the assembled Jacobian as its
+// operator, the Jacobian is assembled at every iteration. Only its
+// factorization, used as a preconditioner, may be reused.
+          const bool update_Jacobian = newton_policy.refresh_requested ();
+          const bool assembled_operator = (par.iterative_linear_solver
+                                           &&
+                                           !par.jacobian_free
+                                           &&
+                                           !par.finite_difference_operator);
+          const bool assemble_Jacobian = ((update_Jacobian || assembled_operator)
+                                          &&
+                                          !par.jacobian_free);
+          if (assemble_Jacobian == true)
             {
 
 // Determine the residual and the Jacobian of the residual.
@@ -2047,18 +2716,19 @@ IFEM<dim>::run ()
                                         1./par.dt,
                                         t);
 
-              if (par.only_NS)
-                JF_inv.initialize (JF.block(0,0)); //: SR Inverse of the Jacobian of the (0,0) block only
-              else
-                JF_inv.initialize (JF);//: Inverse of the Jacobian of the entire system
-
-// Reset the <code>update_Jacobian</code> variable to the value specified
-// in the parameter file.
-              update_Jacobian = par.update_jacobian_continuously;
+              if (update_Jacobian)
+                factorize_jacobian ();
             }
           else
             {
 
+// In the Jacobian-free mode, only the preconditioner is refreshed.
+              if (par.jacobian_free && update_Jacobian)
+                {
+                  assemble_fluid_jacobian (t);
+                  factorize_jacobian ();
+                }
+
 // Determine the residual but do not update the Jacobian.
               residual_and_or_Jacobian (current_res,
                                         dummy_JF,
@@ -2076,100 +2746,163 @@ IFEM<dim>::run ()
 
 
 // Is the norm of the residual sufficiently small?
-          if ( res_norm < TOLF )
+          if (newton_policy.converged (res_norm))
             {
 
 // Make a note and advance to the next step.
               printf (
-                " Step %03d, Res:  %-16.3e (converged in %d iterations)\n\n",
+                " Step %03d, Res:  %-16.3e (converged in %d iterations, "
+                "J refreshed %d times, reused %d times)\n",
                 time_step,
                 res_norm,
-                nonlin_iter
+                newton_policy.n_iterations,
+                newton_policy.n_refreshes,
+                newton_policy.n_reuses
               );
+              if (par.iterative_linear_solver)
+                printf ("   %d linear iterations in %d solves\n",
+                        forcing_term.n_linear_iterations,
+                        forcing_term.n_linear_solves);
+              printf ("\n");
               break;
             }
           else
             {
 
+// With the contraction-rate policy, a residual that did not decrease
+// enough shows that the current factorization is too far from the
+// Jacobian at the current iterate. The Jacobian is then refreshed
+// before the update is computed. The residual is unchanged.
+              if (!update_Jacobian && newton_policy.refresh_requested())
+                {
+                  if (par.jacobian_free)
+                    assemble_fluid_jacobian (t);
+                  else if (!assemble_Jacobian)
+                    residual_and_or_Jacobian (current_res,
+                                              JF,
+                                              current_xit,
+                                              current_xi,
+                                              1./par.dt,
+                                              t);
+                  factorize_jacobian ();
+                }
+              else if (!update_Jacobian)
+                newton_policy.jacobian_reused ();
+
 // If the norm of the residual is not sufficiently small, make a note
 // of it and compute an update.
               cout
-                  << nonlin_iter
+                  << newton_policy.n_iterations
                   << ": "
                   << res_norm
                   << endl;
 
 
+// The finite-difference Jacobian is evaluated at the current state.
+              if (par.jacobian_free || par.finite_difference_operator)
+                fd_jacobian.reinit (current_xi, current_res, t);
+
 // To compute the update to the current $\xi$, we first change the sign
 // of the current value of the residual ...
               current_res *= -1;
 
-              if (par.only_NS)
+// A factorization computed at the current iterate gives the exact
+// Newton update, and there is nothing to gain from GMRES. A stale one
+// is only used as the preconditioner of a few GMRES iterations, which
+// restore the convergence rate of Newton's method without factorizing
+// again.
+              const bool use_krylov = (par.iterative_linear_solver
+                                       &&
+                                       (par.jacobian_free
+                                        ||
+                                        !newton_policy.jacobian_current()));
+
+              if (use_krylov)
                 {
-                  tmp_vec_n_dofs_up = current_res.block(0);
-                  JF_inv.solve(tmp_vec_n_dofs_up);
 
-                  newton_update.block(0) = tmp_vec_n_dofs_up;
+// In the inexact Newton method the update is only computed to the
+// relative accuracy given by the forcing term. The last factorization
+// of the Jacobian is the preconditioner. If the linear solver does not
+// reach the requested accuracy, the update is used anyway, but the
+// factorization is refreshed before computing the next one.
+                  const double eta = forcing_term.value (res_norm);
+                  bool linear_converged = true;
+                  unsigned int linear_iterations = 0;
+
+                  if (par.only_NS)
+                    linear_iterations = solve_gmres (JF.block(0,0),
+                                                     *JF_inv,
+                                                     current_res.block(0),
+                                                     newton_update.block(0),
+                                                     eta*res_norm,
+                                                     par.max_linear_iterations,
+                                                     linear_converged);
+                  else if (par.jacobian_free)
+                    linear_iterations = solve_gmres (fd_jacobian,
+                                                     jacobian_free_preconditioner,
+                                                     current_res,
+                                                     newton_update,
+                                                     eta*res_norm,
+                                                     par.max_linear_iterations,
+                                                     linear_converged);
+                  else if (par.finite_difference_operator)
+                    linear_iterations = solve_gmres (fd_jacobian,
+                                                     *JF_inv,
+                                                     current_res,
+                                                     newton_update,
+                                                     eta*res_norm,
+                                                     par.max_linear_iterations,
+                                                     linear_converged);
+                  else
+                    linear_iterations = solve_gmres (JF,
+                                                     *JF_inv,
+                                                     current_res,
+                                                     newton_update,
+                                                     eta*res_norm,
+                                                     par.max_linear_iterations,
+                                                     linear_converged);
+
+                  forcing_term.linear_solve_done (linear_iterations);
+                  if (!linear_converged)
+                    newton_policy.request_refresh ();
+
+                  cout
+                      << "   eta: "
+                      << eta
+                      << ", linear iterations: "
+                      << linear_iterations
+                      << (linear_converged ? "" : " (not converged)")
+                      << endl;
                 }
+              else if (par.only_NS)
+                JF_inv->vmult (newton_update.block(0), current_res.block(0));
               else
                 {
 
-// ... then we compute the update, which is returned by the method
-// <code>solve</code> of the object <code>JF_inv</code>. The latter is of class
-// <code>SparseDirectUMFPACK</code> and therefore the value of the (negative) of
-// the current residual must be supplied in a container of type
-// <code>Vector<double></code>.  So, we first transfer the information in
-// <code>current_res</code> into temporary storage, and then we carry out the
-// computation of the update.
-                  tmp_vec_n_total_dofs = current_res;
-                  JF_inv.solve(tmp_vec_n_total_dofs);
-
-// Now that we have the updated of the solution into an object of type
-// <code>Vector<double></code>, we repackage it into an object of
-// type <code>BlockVector</code>.
-                  newton_update = tmp_vec_n_total_dofs;
+// ... then we compute the update, by applying the inverse of the
+// Jacobian, i.e. the <code>DirectSolver</code> object
+// <code>JF_inv</code>, to the (negative) of the current residual. The
+// blocks of the residual are gathered once into the contiguous storage
+// the solver works on, and the result is scattered directly into the
+// blocks of the update.
+                  JF_inv->vmult (newton_update, current_res);
                 }
 
 // Finally, we determine the value of the updated solution.
               current_xi.add(1., newton_update);
 
-
-// We are here because the solution needed to be updated. The update
-// was computed using whatever Jacobian was available.  If, on
-// entering this section of the loop, the value of the residual was
-// very poor and if the solution's method indicated in the parameter
-// file did not call for a continuous update of the Jacobian, now we
-// make sure that the Jacobian is updated before computing the next
-// solution update.
-              if (res_norm > 1e-2) update_Jacobian = true;
-            }
-
-
-// We are here because the solution needed an update. So, start
-// counting how many iterations are needed to converge.  If
-// convergence is not achieved in 15 iterations update the Jacobian
-// and try again.  The maximum number of 15-iteration cycles is set
-// (arbitrarily) to three. The counter for the cycle is
-// <code>outer_nonlin_iter</code>.
-          ++nonlin_iter;
-          if (nonlin_iter == 10)
-            {
-              update_Jacobian = true;
-              nonlin_iter = 0;
-              outer_nonlin_iter++;
-              printf(
-                "   %-16.3e (not converged in 10 iterations. Step %d)\n\n",
-                res_norm,
-                outer_nonlin_iter
-              );
-              ///  output_step (t, current_xi, time_step*1000, par.dt);//::Mult pt source
+// The average of the pressure is set to zero.
+              if (pressure_weights.size() != 0)
+                remove_average_pressure (current_xi.block(0));
             }
 
 
-// If convergence is not in our destiny, accept defeat, with as much
-// grace as it can be mustered, and go home.
-          AssertThrow (outer_nonlin_iter <= 3,
-                       ExcMessage ("No convergence in nonlinear solver."));
+// We are here because the solution needed an update. The policy counts
+// the iterations and decides whether the Jacobian must be updated
+// before computing the next update. If convergence is not in our
+// destiny, it accepts defeat, with as much grace as it can be mustered,
+// and throws an exception.
+          newton_policy.update_computed (res_norm);
         }
 
 
@@ -2183,12 +2916,38 @@ IFEM<dim>::run ()
           // if ((time_step==1)||(time_step % par.output_interval==0))
           fsi_bm_postprocess2();
         }
-      update_Jacobian = par.update_jacobian_continuously;
-      if (par.update_jacobian_at_step_beginning) update_Jacobian = true;
+      write_probes (t);
+
+// Checkpoints of the state are written at the requested intervals.
+      if (checkpoint_due ())
+        save_for_restart ();
 
+// The control volume follows the immersed domain when the latter is no
+// longer in its finest cells.
+      if (par.remesh_interval_f > 0
+          &&
+          time_step % par.remesh_interval_f == 0)
+        {
+          update_mapping_and_coupling (previous_xi.block(1));
+          if (immersed_domain_left_refined_region ())
+            remesh_fluid ();
+        }
     }
 // End of the cycle over time.
 
+  printf (" Newton iterations: %d, J refreshed %d times, reused %d times\n",
+          newton_policy.n_total_iterations,
+          newton_policy.n_total_refreshes,
+          newton_policy.n_total_reuses);
+  if (par.iterative_linear_solver)
+    printf (" Linear iterations: %d in %d solves\n",
+            forcing_term.n_total_linear_iterations,
+            forcing_term.n_total_linear_solves);
+  if (par.jacobian_free || par.finite_difference_operator)
+    printf (" Residuals evaluated for Jacobian-vector products: %d\n",
+            fd_jacobian.n_residuals);
+  JF_inv->print_statistics (cout, "Jacobian");
+
   if (par.material_model == IFEMParameters<dim>::CircumferentialFiberModel)
     calculate_error();
 
@@ -2218,6 +2977,10 @@ IFEM<dim>::output_step
       << h
       << endl;
 
+// The immersed domain is shown in the configuration corresponding to
+// the solution being written.
+  mapping_displacement = solution.block(1);
+
   global_info_file
       << t
       << " ";
@@ -2231,6 +2994,15 @@ IFEM<dim>::output_step
                                        Utilities::int_to_string (step, 5) +
                                        ".bin").c_str() );
     solution.block(1).block_write(solid_binary_file);
+
+    steps_file
+        << step
+        << " "
+        << setprecision(17)
+        << t
+        << " "
+        << h
+        << endl;
   }
 
   if ((step % par.output_interval==0) || (_output))
@@ -2288,9 +3060,6 @@ IFEM<dim>::output_step
 
 
 // Assemble in and out flux.
-    typename DoFHandler<dim,dim>::active_cell_iterator
-    cell = dh_f.begin_active(),
-    endc = dh_f.end();
     QGauss<dim-1> face_quad(par.degree+2);
     FEFaceValues<dim,dim> fe_v (fe_f,
                                 face_quad,
@@ -2301,21 +3070,22 @@ IFEM<dim>::output_step
     vector<Vector<double> > local_vp(face_quad.size(),
                                      Vector<double>(dim+1));
 
+    const vector<typename GeometryCache<dim>::CellFace> &faces
+      = fluid_geometry.boundary_faces;
+
     double flux=0;
-    for (; cell != endc; ++cell)
-      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
-        if (cell->face(f)->at_boundary())
+    for (unsigned int b=0; b<faces.size(); ++b)
+      {
+        fe_v.reinit(faces[b].first, faces[b].second);
+        fe_v.get_function_values(solution.block(0), local_vp);
+        const vector<Tensor<1,dim> > &normals = fe_v.get_normal_vectors();
+        for (unsigned int q=0; q<face_quad.size(); ++q)
           {
-            fe_v.reinit(cell, f);
-            fe_v.get_function_values(solution.block(0), local_vp);
-            const vector<Tensor<1,dim> > &normals = fe_v.get_normal_vectors();
-            for (unsigned int q=0; q<face_quad.size(); ++q)
-              {
-                Point<dim> vq;
-                for (unsigned int d=0; d<dim; ++d) vq[d] = local_vp[q](d);
-                flux += (vq*normals[q])*fe_v.JxW(q);
-              }
+            Point<dim> vq;
+            for (unsigned int d=0; d<dim; ++d) vq[d] = local_vp[q](d);
+            flux += (vq*normals[q])*fe_v.JxW(q);
           }
+      }
     global_info_file
         << flux
         << " ";
@@ -2366,20 +3136,16 @@ IFEM<dim>::get_Agamma_values
   const FEValues<dim,dim> &fe_v_s,
   const vector< unsigned int > &dofs,
   const Vector<double> &xi,
-  Vector<double> &local_A_gamma
+  Vector<double> &local_A_gamma,
+  AssemblyScratch<dim> &scratch_data
 )
 {
   set_to_zero(local_A_gamma);
 
   unsigned int qsize = fe_v_s.get_quadrature().size();
 
-  vector< vector< Tensor<1,dim> > >
-  H(qsize, vector< Tensor<1,dim> >(dim));
-  fe_v_s.get_function_gradients(xi, H);
-
-  vector<Tensor<2,dim,double> > P (qsize, Tensor<2,dim,double>());
-  vector<Tensor<2,dim,double> > tmp1;
-  vector< vector<Tensor<2,dim,double> > > tmp2;
+  vector<Tensor<2,dim,double> > &P = scratch_data.P;
+  Assert (P.size() == qsize, ExcDimensionMismatch (P.size(), qsize));
 
   get_Pe_F_and_DPeFT_dxi_values (
     fe_v_s,
@@ -2387,8 +3153,9 @@ IFEM<dim>::get_Agamma_values
     xi,
     false,
     P,
-    tmp1,
-    tmp2
+    scratch_data.no_F,
+    scratch_data.no_DPeFT_dxi,
+    scratch_data.H
   );
 
   for ( unsigned int qs = 0; qs < qsize; ++qs )
@@ -2420,12 +3187,13 @@ IFEM<dim>::get_Pe_F_and_DPeFT_dxi_values (
   const bool update_jacobian,
   vector<Tensor<2,dim,double> > &Pe,
   vector<Tensor<2,dim,double> > &vec_F,
-  vector< vector<Tensor<2,dim,double> > > &DPeFT_dxi
+  vector< vector<Tensor<2,dim,double> > > &DPeFT_dxi,
+  vector< vector< Tensor<1,dim> > > &H
 )
 {
-  vector< vector< Tensor<1,dim> > >
-  H(Pe.size(), vector< Tensor<1,dim> >(dim));
-  fe_v_s.get_function_gradients(xi, H);
+// The gradient of the displacement. <code>H</code> must have at least as
+// many elements as <code>Pe</code>.
+  get_local_function_gradients (fe_v_s, fe_s, dofs, xi, Pe.size(), H);
 
   Tensor<2,dim,double> F;
 
@@ -2748,18 +3516,16 @@ IFEM<dim>::apply_constraints
   unsigned int offset
 )
 {
-  map<unsigned int,double>::iterator it;
-
   if (offset == 0) //: i.e. constraints need to be applied for fluid dofs
     for (unsigned int i=0; i<dofs.size(); ++i)
       {
-        it = par.boundary_values.find(dofs[i]);
-        if (it != par.boundary_values.end() )
+        if (dense_boundary_values.is_constrained(dofs[i]))
           {
 
 // Setting the value of the residual equal to the difference between
 // the current value and the the prescribed value.
-            local_res[i] = scaling * ( value_of_dofs(dofs[i]) - it->second );
+            local_res[i] = scaling * ( value_of_dofs(dofs[i]) -
+                                       dense_boundary_values.value(dofs[i]) );
             if ( !local_jacobian.empty() )
               {
 
@@ -2784,13 +3550,13 @@ IFEM<dim>::apply_constraints
   else //: i.e. constraints need to be applied for solid dofs
     for (unsigned int i=0, wi = offset; i <dofs.size(); ++i, ++wi)
       {
-        it = par.boundary_values_solid.find(dofs[i]);
-        if (it != par.boundary_values_solid.end() || par.cfd_test )
+        if (dense_boundary_values_solid.is_constrained(dofs[i]) || par.cfd_test )
           {
             // Setting the value of the residual equal to the difference between
             // the current value and the the prescribed value.
             local_res[wi] = scaling * ( value_of_dofs(dofs[i]) -
-                                        (par.cfd_test ? 0.0 : it->second ));//: SR---For cfd test, the presribed value is zero for all dofs of the solid
+                                        (par.cfd_test ? 0.0 :
+                                         dense_boundary_values_solid.value(dofs[i])));//: SR---For cfd test, the presribed value is zero for all dofs of the solid
             if ( !local_jacobian.empty() )
               {
                 // Here we simply let the Jacobian know that the current dof is actually not a dof.
@@ -2802,6 +3568,82 @@ IFEM<dim>::apply_constraints
       }
 }
 
+// Enforcement of the hanging node constraints of the control volume,
+// once the residual and the Jacobian have been assembled without them.
+// The equation of each constrained dof $i$ is added to the equations of
+// the dofs $j$ constraining it, with the weights $c_{ij}$ of the
+// constraint, which amounts to testing with the conforming shape
+// functions. It is then replaced by the constraint itself,
+// $x_i - \sum_j c_{ij} x_j = 0$, scaled as the boundary conditions.
+// The equations of the dofs with prescribed values, and the one of the
+// constraining dof of the pressure, are not affected, since they have
+// been replaced as well.
+
+template <int dim>
+void
+IFEM<dim>::apply_hanging_node_constraints
+(
+  BlockVector<double> &residual,
+  BlockSparseMatrix<double> &jacobian,
+  const Vector<double> &up
+)
+{
+  const bool update_jacobian = !jacobian.empty();
+  const bool pressure_row_replaced = (par.all_DBC
+                                     && !par.fix_pressure
+                                     && !par.solid_is_compressible);
+
+  for (unsigned int h=0; h<hanging_dofs_f.size(); ++h)
+    {
+      const unsigned int i = hanging_dofs_f[h];
+      if (dense_boundary_values.is_constrained(i))
+        continue;
+
+      const vector< pair<types::global_dof_index,double> > &entries
+        = *constraints_f.get_constraint_entries(i);
+
+      double constraint = up(i);
+      for (unsigned int k=0; k<entries.size(); ++k)
+        {
+          const unsigned int j = entries[k].first;
+          const double c_ij = entries[k].second;
+          constraint -= c_ij * up(j);
+
+          if (dense_boundary_values.is_constrained(j)
+              ||
+              (pressure_row_replaced && j == constraining_dof))
+            continue;
+
+          residual.block(0)(j) += c_ij * residual.block(0)(i);
+          if (update_jacobian)
+            for (unsigned int b=0; b<jacobian.n_block_cols(); ++b)
+              {
+                SparseMatrix<double> &J = jacobian.block(0,b);
+                for (SparseMatrix<double>::const_iterator e = J.begin(i);
+                     e != J.end(i); ++e)
+                  J.add (j, e->column(), c_ij * e->value());
+              }
+        }
+
+      residual.block(0)(i) = scaling * constraint;
+      if (update_jacobian)
+        {
+          for (unsigned int b=0; b<jacobian.n_block_cols(); ++b)
+            {
+              SparseMatrix<double> &J = jacobian.block(0,b);
+              for (SparseMatrix<double>::iterator e = J.begin(i);
+                   e != J.end(i); ++e)
+                e->value() = 0;
+            }
+          jacobian.block(0,0).set (i, i, scaling);
+          for (unsigned int k=0; k<entries.size(); ++k)
+            jacobian.block(0,0).add (i,
+                                     entries[k].first,
+                                     -scaling * entries[k].second);
+        }
+    }
+}
+
 // Assemble the pressure constraint into the residual.
 template <int dim>
 void
@@ -2825,12 +3667,17 @@ IFEM<dim>::distribute_constraint_on_pressure
   const unsigned int offset
 )
 {
+// When the average pressure is projected out, only the diagonal entry
+// of the row is kept, which keeps the Jacobian sparse. The Newton update
+// of the average pressure is then approximate, but the projection
+// following each update makes it exact.
   for (unsigned int i=0, wi=offset; i<dofs.size(); ++i,++wi)
-    jacobian.add(
-      constraining_dof,
-      dofs[i],
-      pressure_coefficient[wi]*scaling/area
-    );
+    if (!par.project_pressure || dofs[i] == constraining_dof)
+      jacobian.add(
+        constraining_dof,
+        dofs[i],
+        pressure_coefficient[wi]*scaling/area
+      );
 
 }
 
@@ -2851,37 +3698,37 @@ IFEM<dim>::localize
 }
 
 
+// Location of the point sources in the control volume. The point
+// source vector of <code>deal.II</code> is
+//    integral_over_control_volume(Dirac_delta( x - x_source)*shape_fn(i))
+// for all test functions defined over the control volume, i.e., the
+// values at the source of the shape functions of the cell containing it.
+// We only need the contribution of the test functions pertaining to
+// the Lagrange multiplier.
+
+template <int dim>
+void
+IFEM<dim>::initialize_point_sources ()
+{
+  point_sources.clear ();
+  for (unsigned int i=0; i < par.n_pt_source; ++i)
+    point_sources.add (par.pt_source_location[i],
+                       *par.pt_source_function[i],
+                       par.pt_source_scale[i]);
+
+  point_sources.initialize (StaticMappingQ1<dim>::mapping, dh_f, dim);
+}
+
+
 // Determination of the volume flux vector corresponding to the point source.
 template <int dim>
 void
 IFEM<dim>::get_volume_flux_vector (const double t)
 {
-  double strength;
-
-  for (unsigned int i=0; i < par.n_pt_source; ++i)
-    {
-      // Evaluate the source strength at the current time
-      par.pt_source_strength[i]->set_time(t);
-
-      strength = par.pt_source_strength[i]->value(par.pt_source_location[i]);
-
-      VectorTools::create_point_source_vector(dh_f,
-                                              par.pt_source_location[i],
-                                              tmp_vec_n_dofs_up);
-
-      // What we have obtained using <code>deal.II</code> is this:
-      // tmp_vec_n_dofs_up =
-      //    integral_over_control_volume(Dirac_delta( x - x_source)*shape_fn(i))
-      // for all test functions defined over the control volume
-      // Also, we need to slightly modify the contribution by
-      // multiplying it with a factor equal to the source strength over the density of
-      // the fluid
-      tmp_vec_n_dofs_up *= strength/par.rho_f;
-      volume_flux += tmp_vec_n_dofs_up;
-    }
-  // We need to consider only the contribution of the test functions pertaining to
-  // the Lagrange multiplier.
-  fill(volume_flux.begin(), volume_flux.begin()+n_dofs_u, 0.0);
+// The strengths of all the sources are evaluated at the current time,
+// and the contribution of each source is multiplied by a factor equal
+// to its strength over the density of the fluid.
+  point_sources.assemble (t, 1.0/par.rho_f, volume_flux);
 }
 
 
@@ -2997,20 +3844,100 @@ IFEM<dim>::calculate_error () const
 }
 
 
+// Location of the probe points. Points A and B of the Turek-Hron
+// benchmarks are fixed in the mesh of the control volume, with the
+// exception of point A in the FSI tests, which is fixed in the
+// reference configuration of the flag.
+
+template <int dim>
+void
+IFEM<dim>::initialize_probes ()
+{
+  if (par.fsi_bm)
+    {
+      //: Some geometric features of the benchmark test(s)
+      const Point<dim> center_cyl (0.2, 0.2); //: Center of the cylinder
+      const double D_cyl = 0.1; //: Diameter of the cylinder
+      const double l_flag = 0.35; //: Length of the flag
+
+      //: Pt. A is the midpt of the end of the tail, pt. B the stagnation pt.
+      Point<dim> point_A (center_cyl[0]+0.5*D_cyl+l_flag, center_cyl[1]);
+      const Point<dim> point_B (center_cyl[0]-0.5*D_cyl, center_cyl[1]);
+
+      if (par.cfd_test)
+        {
+          //: Point A now corresponds to midpoint of the aft edge of the cylinder
+          point_A[0] -= l_flag;
+          probe_A.initialize (StaticMappingQ1<dim>::mapping, dh_f, point_A,
+                              &fluid_grid);
+        }
+      else
+        probe_A.initialize (StaticMappingQ1<dim>::mapping, dh_s, point_A);
+
+      probe_B.initialize (StaticMappingQ1<dim>::mapping, dh_f, point_B,
+                          &fluid_grid);
+    }
+
+  fluid_probes.resize (par.fluid_probe_points.size());
+  for (unsigned int i=0; i<fluid_probes.size(); ++i)
+    fluid_probes[i].initialize (StaticMappingQ1<dim>::mapping,
+                                dh_f,
+                                par.fluid_probe_points[i],
+                                &fluid_grid);
+
+  solid_probes.resize (par.solid_probe_points.size());
+  for (unsigned int i=0; i<solid_probes.size(); ++i)
+    solid_probes[i].initialize (StaticMappingQ1<dim>::mapping,
+                                dh_s,
+                                par.solid_probe_points[i]);
+}
+
+
+// Output of velocity and pressure at the fluid probes and of the
+// displacement at the solid probes.
+
+template <int dim>
+void
+IFEM<dim>::write_probes (const double t)
+{
+  if (fluid_probes.empty() && solid_probes.empty())
+    return;
+
+  Vector<double> up (dim+1);
+  Vector<double> W (dim);
+
+  probes_out_file.unsetf(ios_base::floatfield);
+  probes_out_file << t << scientific;
+
+  for (unsigned int i=0; i<fluid_probes.size(); ++i)
+    {
+      fluid_probes[i].value (current_xi.block(0), up);
+      for (unsigned int c=0; c<dim+1; ++c)
+        probes_out_file << "\t" << up(c);
+    }
+
+  for (unsigned int i=0; i<solid_probes.size(); ++i)
+    {
+      solid_probes[i].value (current_xi.block(1), W);
+      for (unsigned int c=0; c<dim; ++c)
+        probes_out_file << "\t" << W(c);
+    }
+
+  probes_out_file << endl;
+}
+
+
 //Calculation and output of tip displacement of the flag and lift-drag on the
 // cylinder+flag in the Turek-Hron FSI benchmark test
 template <int dim>
 void IFEM<dim>::fsi_bm_postprocess()
 {
   //: Some geometric features of the benchmark test(s)
-  const Point<dim> center_cyl (0.2, 0.2); //: Center of the cylinder
   const double D_cyl = 0.1; //: Diameter of the cylinder
   const double H = 0.41; //: Height of the channel
-  const double l_flag = 0.35; //: Length of the flag
 
-  //Compute the the displacement of the pt. A (i.e. the midpt of the end of the tail)
-  Point<dim> point_A (center_cyl[0]+0.5*D_cyl+l_flag, center_cyl[1]);
-  Point<dim> point_B (center_cyl[0]-0.5*D_cyl, center_cyl[1]);
+  //Compute the the displacement of the pt. A (i.e. the midpt of the end of the tail).
+  //Points A and B are located once and for all by initialize_probes().
   Vector<double> disp_A (dim);
   Vector<double> sol_B (dim+1);
   double pressure_A = 0.0;
@@ -3021,14 +3948,8 @@ void IFEM<dim>::fsi_bm_postprocess()
   if (par.cfd_test)
     {
       //: Point A now corresponds to midpoint of the aft edge of the cylinder
-      point_A[0] -= l_flag;
-
       //: Extract the value of pressure at point A
-      VectorTools::point_value(dh_f,
-                               current_xi.block(0),
-                               point_A,
-                               sol_B);
-      pressure_A = sol_B(dim);
+      pressure_A = probe_A.value(current_xi.block(0), dim);
 
       //: Evaluate the average value of the inflow velocity for t=4s for CFDBM1-3
       par.u_g.set_time(4.0);
@@ -3037,22 +3958,13 @@ void IFEM<dim>::fsi_bm_postprocess()
 
     }
   else
-    VectorTools::point_value(dh_s,
-                             current_xi.block(1),
-                             point_A,
-                             disp_A);
+    probe_A.value(current_xi.block(1), disp_A);
 
-  VectorTools::point_value(dh_f,
-                           current_xi.block(0),
-                           point_B,
-                           sol_B);
+  probe_B.value(current_xi.block(0), sol_B);
 
   //-------------------- Loop over FLUID CELLS-----------------//
   //Calculating the drag and lift values corresponding to the free surface of the cylinder
 
-  typename DoFHandler<dim,dim>::active_cell_iterator
-  cell = dh_f.begin_active(), endc = dh_f.end();
-
   QGauss <dim-1> quad_face (par.degree+2);
   unsigned int n_qpf = quad_face.size();
 
@@ -3082,63 +3994,63 @@ void IFEM<dim>::fsi_bm_postprocess()
   double c_L_turekstyle = 0.;
   double c_D_turekstyle = 0.;
   //:-----------------------
-  unsigned int c_no = 0;
-  for (; cell !=endc; ++cell, ++c_no)
+  // Boundary faces on the cylinder, and also on the flag for the CFD tests.
+  vector<typename GeometryCache<dim>::CellFace> faces
+    = fluid_geometry.faces_with_manifold_id (80);
+  if (par.cfd_test)
+    faces.insert (faces.end(),
+                  fluid_geometry.faces_with_manifold_id (81).begin(),
+                  fluid_geometry.faces_with_manifold_id (81).end());
+
+  for (unsigned int b=0; b<faces.size(); ++b)
     {
-      for (unsigned int face=0; face < GeometryInfo<dim>::faces_per_cell; ++face)
-        {
-          if (cell->face(face)->at_boundary()
-              && (cell->face(face)->manifold_id() == 80
-                  || (par.cfd_test && cell->face(face)->manifold_id() == 81)
-                 )
-             )
-            {
-              cell->get_dof_indices (dofs_f);
+      const typename DoFHandler<dim,dim>::active_cell_iterator &cell = faces[b].first;
+      const unsigned int face = faces[b].second;
+
+      cell->get_dof_indices (dofs_f);
 
-              fe_f_face_v.reinit (cell, face);
+      fe_f_face_v.reinit (cell, face);
 
-              fe_f_face_v.get_function_values (current_xi.block(0), sol_f);
-              fe_f_face_v.get_function_gradients (current_xi.block(0), sol_grad_f);
+      fe_f_face_v.get_function_values (current_xi.block(0), sol_f);
+      fe_f_face_v.get_function_gradients (current_xi.block(0), sol_grad_f);
 
-              for (unsigned int q = 0; q < n_qpf; ++q) //loop over quadrature pts
-                {
-                  for (unsigned int i = 0; i < dim; ++i) //loop over dim
-                    for (unsigned int j = 0; j < dim; ++j) //loop over dim
-                      drag_lift_cyl[i] += //(T_f - p I)*(-n da) //-n since +n is outward wrt solid cell boundary
-                        (par.eta_f
-                         *(sol_grad_f[q][i][j]
-                           + sol_grad_f[q][j][i])
-                         - (i == j ? sol_f[q](dim) : 0.0)
-                        )
-                        *(-fe_f_face_v.normal_vector(q)[j])
-                        *fe_f_face_v.JxW(q);
-                  //Turek-style calculations to follow:
-                  normal_vector = -fe_f_face_v.normal_vector(q);
-                  tangent_vector[0] = normal_vector[1];
-                  tangent_vector[1] = -normal_vector[0];
-                  gradn_u_t = 0.0;
-                  for (unsigned int i = 0; i < dim; ++i)
-                    gradn_u_t +=tangent_vector[i]
-                                *(sol_grad_f[q][i]
-                                  *normal_vector);
-
-                  drag_lift_turekstyle[0] += (-sol_f[q](dim)
-                                              * normal_vector[0]
-                                              + par.eta_f
-                                              * gradn_u_t
-                                              * normal_vector[1])
-                                             *fe_f_face_v.JxW(q);
-                  drag_lift_turekstyle[1] += (-sol_f[q](dim)
-                                              * normal_vector[1]
-                                              - par.eta_f
-                                              * gradn_u_t
-                                              * normal_vector[0])
-                                             *fe_f_face_v.JxW(q);
-
-                }//loop over q
-            }//if cond.
-        }//loop over faces
-    }//loop over cell
+      for (unsigned int q = 0; q < n_qpf; ++q) //loop over quadrature pts
+        {
+          for (unsigned int i = 0; i < dim; ++i) //loop over dim
+            for (unsigned int j = 0; j < dim; ++j) //loop over dim
+              drag_lift_cyl[i] += //(T_f - p I)*(-n da) //-n since +n is outward wrt solid cell boundary
+                (par.eta_f
+                 *(sol_grad_f[q][i][j]
+                   + sol_grad_f[q][j][i])
+                 - (i == j ? sol_f[q](dim) : 0.0)
+                )
+                *(-fe_f_face_v.normal_vector(q)[j])
+                *fe_f_face_v.JxW(q);
+          //Turek-style calculations to follow:
+          normal_vector = -fe_f_face_v.normal_vector(q);
+          tangent_vector[0] = normal_vector[1];
+          tangent_vector[1] = -normal_vector[0];
+          gradn_u_t = 0.0;
+          for (unsigned int i = 0; i < dim; ++i)
+            gradn_u_t +=tangent_vector[i]
+                        *(sol_grad_f[q][i]
+                          *normal_vector);
+
+          drag_lift_turekstyle[0] += (-sol_f[q](dim)
+                                      * normal_vector[0]
+                                      + par.eta_f
+                                      * gradn_u_t
+                                      * normal_vector[1])
+                                     *fe_f_face_v.JxW(q);
+          drag_lift_turekstyle[1] += (-sol_f[q](dim)
+                                      * normal_vector[1]
+                                      - par.eta_f
+                                      * gradn_u_t
+                                      * normal_vector[0])
+                                     *fe_f_face_v.JxW(q);
+
+        }//loop over q
+    }//loop over faces
 
   ///-------------------- Loop over FLUID CELLS (end)-----------------//
   if (par.cfd_test && (abs(U_avg)>1e-8))
@@ -3152,16 +4064,11 @@ void IFEM<dim>::fsi_bm_postprocess()
     }
   else //: if the regular FSI BM test is being performed
     {
-      //We find the solid cell in which point A resides and then
-      //associate a quadrature point with point A. Note a quadrature point can only
+      //The solid cell in which point A resides is known from its probe, and
+      //we associate a quadrature point with point A. Note a quadrature point can only
       //lie in a unit cell.
-      const pair<typename DoFHandler<dim, dim>::active_cell_iterator, Point<dim> > cell_and_point
-        = GridTools::find_active_cell_around_point (StaticMappingQ1<dim, dim>::mapping,
-                                                    dh_s,
-                                                    point_A);
-
-      typename DoFHandler<dim, dim>::active_cell_iterator cell_having_point_A = cell_and_point.first;
-      Point<dim> unit_cell_point_A = GeometryInfo<dim>::project_to_unit_cell(cell_and_point.second);
+      const typename DoFHandler<dim, dim>::active_cell_iterator cell_having_point_A = probe_A.cell;
+      const Point<dim> unit_cell_point_A = probe_A.unit_point;
 
 
       Quadrature<dim> quad_point_A (unit_cell_point_A);
@@ -3223,6 +4130,7 @@ void IFEM<dim>::fsi_bm_postprocess()
 
       vector<Tensor<2,dim,double> > Pe(n_qps, Tensor<2,dim,double>());
       vector< vector<Tensor<2,dim,double> > > DPeFT_dxi;
+      vector< vector< Tensor<1,dim> > > H (n_qps, vector< Tensor<1,dim> > (dim));
 
       vector<Tensor<2,dim,double> > F(n_qps, Tensor<2,dim,double>());
       vector<Tensor<2,dim,double> > inv_FT(n_qps, Tensor<2,dim,double>());
@@ -3277,174 +4185,175 @@ void IFEM<dim>::fsi_bm_postprocess()
 
         }
 
-      M_gamma3_inv.solve(tmp_vec_n_dofs_W);
+      M_gamma3_inv->solve(tmp_vec_n_dofs_W);
 
 //The actual calculations of the drag and the lift on the flag are done in the
 //following section of the code:
-      for (cell_s = dh_s.begin_active(); cell_s != endc_s; ++cell_s)
+      const vector<typename GeometryCache<dim>::CellFace> &solid_faces
+        = solid_geometry.boundary_faces;
+      for (unsigned int b=0; b<solid_faces.size(); ++b)
         {
-          for (unsigned int face = 0; face < GeometryInfo<dim>::faces_per_cell; ++face)
+          cell_s = solid_faces[b].first;
+          const unsigned int face = solid_faces[b].second;
+
+          if (cell_s->face(face)->manifold_id() != 81)
             {
-              if (cell_s->face(face)->at_boundary() && (cell_s->face(face)->manifold_id() !=81))
-                {
-                  cell_s->get_dof_indices(dofs_s);
+              cell_s->get_dof_indices(dofs_s);
 
-                  fe_s_face_v.reinit (cell_s, face);
+              fe_s_face_v.reinit (cell_s, face);
 
-                  fe_s_face_v.get_function_values (tmp_vec_n_dofs_W,
-                                                   projected_p);
+              fe_s_face_v.get_function_values (tmp_vec_n_dofs_W,
+                                               projected_p);
 
-                  fe_s_face_v.get_function_gradients (current_xi.block(1),
-                                                      sol_grad_s);
+              fe_s_face_v.get_function_gradients (current_xi.block(1),
+                                                  sol_grad_s);
 
-                  //Contribution due to the elastic stress of the solid--------
-                  get_Pe_F_and_DPeFT_dxi_values (fe_s_face_v,
-                                                 dofs_s,
-                                                 current_xi.block(1),
-                                                 false,
-                                                 Pe,
-                                                 F,
-                                                 DPeFT_dxi);
+              //Contribution due to the elastic stress of the solid--------
+              get_Pe_F_and_DPeFT_dxi_values (fe_s_face_v,
+                                             dofs_s,
+                                             current_xi.block(1),
+                                             false,
+                                             Pe,
+                                             F,
+                                             DPeFT_dxi,
+                                             H);
 
-                  for (unsigned int qs = 0; qs < n_qps; ++qs)
-                    {
-                      det_F(qs) = determinant(F[qs]);
-                      inv_FT[qs] = transpose(invert(F[qs]));
-
-                      flag_sum_traction_s_e[qs] = //Pe*N
-                        (Pe[qs]
-                         *fe_s_face_v.normal_vector(qs))
-                        *fe_s_face_v.JxW(qs);
-
-                      //Using the projected value of p
-                      if (!par.solid_is_compressible)
-                        flag_sum_traction_s_inc[qs] = //(- p_projected I)*(J F^(-T) N dA)
-                          - projected_p[qs](0)
-                          * det_F(qs)
-                          * (inv_FT[qs]
-                             * fe_s_face_v.normal_vector(qs))
-                          * fe_s_face_v.JxW(qs);
-                    }
+              for (unsigned int qs = 0; qs < n_qps; ++qs)
+                {
+                  det_F(qs) = determinant(F[qs]);
+                  inv_FT[qs] = transpose(invert(F[qs]));
+
+                  flag_sum_traction_s_e[qs] = //Pe*N
+                    (Pe[qs]
+                     *fe_s_face_v.normal_vector(qs))
+                    *fe_s_face_v.JxW(qs);
+
+                  //Using the projected value of p
+                  if (!par.solid_is_compressible)
+                    flag_sum_traction_s_inc[qs] = //(- p_projected I)*(J F^(-T) N dA)
+                      - projected_p[qs](0)
+                      * det_F(qs)
+                      * (inv_FT[qs]
+                         * fe_s_face_v.normal_vector(qs))
+                      * fe_s_face_v.JxW(qs);
+                }
 
-                  fe_s_face_v_mapped.reinit(cell_s, face);
+              fe_s_face_v_mapped.reinit(cell_s, face);
 
-                  up_field.compute_point_locations (fe_s_face_v_mapped.get_quadrature_points(),
-                                                    fluid_cells,
-                                                    fluid_qpoints,
-                                                    fluid_maps);
+              up_field.compute_point_locations (fe_s_face_v_mapped.get_quadrature_points(),
+                                                fluid_cells,
+                                                fluid_qpoints,
+                                                fluid_maps);
 
-                  for (unsigned int c=0; c<fluid_cells.size(); ++c)
-                    {
-                      Quadrature<dim> local_quad (fluid_qpoints[c]);
-                      FEValues<dim> local_fe_f_v (fe_f,
-                                                  local_quad,
-                                                  update_values |
-                                                  update_gradients);
+              for (unsigned int c=0; c<fluid_cells.size(); ++c)
+                {
+                  Quadrature<dim> local_quad (fluid_qpoints[c]);
+                  FEValues<dim> local_fe_f_v (fe_f,
+                                              local_quad,
+                                              update_values |
+                                              update_gradients);
 
-                      local_fe_f_v.reinit(fluid_cells[c]);
+                  local_fe_f_v.reinit(fluid_cells[c]);
 
-                      set_to_zero(sol_f);
-                      sol_f.resize (local_quad.size(), Vector<double>(dim+1));
-                      local_fe_f_v.get_function_values (current_xi.block(0),
-                                                        sol_f);
+                  set_to_zero(sol_f);
+                  sol_f.resize (local_quad.size(), Vector<double>(dim+1));
+                  local_fe_f_v.get_function_values (current_xi.block(0),
+                                                    sol_f);
 
 
-                      set_to_zero(sol_grad_f);
-                      sol_grad_f.resize (local_quad.size(),
-                                         vector< Tensor<1,dim> >(dim+1)
-                                        );
-                      local_fe_f_v.get_function_gradients (current_xi.block(0),
-                                                           sol_grad_f);
+                  set_to_zero(sol_grad_f);
+                  sol_grad_f.resize (local_quad.size(),
+                                     vector< Tensor<1,dim> >(dim+1)
+                                    );
+                  local_fe_f_v.get_function_gradients (current_xi.block(0),
+                                                       sol_grad_f);
 
 
-                      for (unsigned int q=0; q<local_quad.size(); ++q)
-                        {
-                          unsigned int &qs = fluid_maps[c][q];
+                  for (unsigned int q=0; q<local_quad.size(); ++q)
+                    {
+                      unsigned int &qs = fluid_maps[c][q];
 
-                          flag_sum_traction_f = 0.0;
-                          flag_sum_traction_s_v = 0.0;
-                          flag_sum_traction_s_inc2 = 0.0;
+                      flag_sum_traction_f = 0.0;
+                      flag_sum_traction_s_v = 0.0;
+                      flag_sum_traction_s_inc2 = 0.0;
 
-                          for (unsigned int i = 0; i < dim; ++i)
+                      for (unsigned int i = 0; i < dim; ++i)
+                        {
+                          for (unsigned int j = 0; j < dim; ++j)
                             {
-                              for (unsigned int j = 0; j < dim; ++j)
-                                {
-                                  flag_sum_traction_f[i] += //(T_f - p I)*(J F^(-T) N dA)
-                                    (par.eta_f
-                                     *(sol_grad_f[q][i][j]
-                                       + sol_grad_f[q][j][i])
-                                     - (i == j ? sol_f[q](dim): 0.0)
-                                    )
-                                    *det_F(qs)
-                                    * (inv_FT[qs]
-                                       *fe_s_face_v.normal_vector(qs))[j]
-                                    *fe_s_face_v.JxW(qs);
-
-                                  flag_sum_traction_s_v[i] += //T_s*(J F^(-T) N dA)
-                                    par.eta_s
-                                    *(sol_grad_f[q][i][j]
-                                      + sol_grad_f[q][j][i])
-                                    *det_F(qs)
-                                    * (inv_FT[qs]
-                                       *fe_s_face_v.normal_vector(qs))[j]
-                                    *fe_s_face_v.JxW(qs);
-                                }
-
-                              /*  if(!par.solid_is_compressible)
-                                  flag_sum_traction_s_inc2[i] = //(- p I)*(J F^(-T) N dA)
-                                     - sol_f[q](dim)
-                                     * det_F(qs)
-                                     * (inv_FT[qs]
-                                     * fe_s_face_v.normal_vector(qs))[i]
-                                     * fe_s_face_v.JxW(qs);
-                               */
-
+                              flag_sum_traction_f[i] += //(T_f - p I)*(J F^(-T) N dA)
+                                (par.eta_f
+                                 *(sol_grad_f[q][i][j]
+                                   + sol_grad_f[q][j][i])
+                                 - (i == j ? sol_f[q](dim): 0.0)
+                                )
+                                *det_F(qs)
+                                * (inv_FT[qs]
+                                   *fe_s_face_v.normal_vector(qs))[j]
+                                *fe_s_face_v.JxW(qs);
+
+                              flag_sum_traction_s_v[i] += //T_s*(J F^(-T) N dA)
+                                par.eta_s
+                                *(sol_grad_f[q][i][j]
+                                  + sol_grad_f[q][j][i])
+                                *det_F(qs)
+                                * (inv_FT[qs]
+                                   *fe_s_face_v.normal_vector(qs))[j]
+                                *fe_s_face_v.JxW(qs);
                             }
 
-                          flag_sum_traction_s = flag_sum_traction_s_v
-                                                + flag_sum_traction_s_inc[qs]
-                                                + flag_sum_traction_s_e[qs];
+                          /*  if(!par.solid_is_compressible)
+                              flag_sum_traction_s_inc2[i] = //(- p I)*(J F^(-T) N dA)
+                                 - sol_f[q](dim)
+                                 * det_F(qs)
+                                 * (inv_FT[qs]
+                                 * fe_s_face_v.normal_vector(qs))[i]
+                                 * fe_s_face_v.JxW(qs);
+                           */
 
-                          drag_lift_flag_f += flag_sum_traction_f;
-                          drag_lift_flag_s += flag_sum_traction_s;
+                        }
 
-                          drag_lift_flag_avg += 0.5*( flag_sum_traction_f + flag_sum_traction_s);
+                      flag_sum_traction_s = flag_sum_traction_s_v
+                                            + flag_sum_traction_s_inc[qs]
+                                            + flag_sum_traction_s_e[qs];
 
-                        }
+                      drag_lift_flag_f += flag_sum_traction_f;
+                      drag_lift_flag_s += flag_sum_traction_s;
+
+                      drag_lift_flag_avg += 0.5*( flag_sum_traction_f + flag_sum_traction_s);
 
                     }
 
-                  //--------------------------------------------------------------//
-                  //-------        CALCULATION OF PRESSURE AT POINT A ------------//
-                  //--------------------------------------------------------------//
-                  //Calculate the pressure at point A & the viscous stress (if any)
-                  if (cell_s == cell_having_point_A)
-                    {
-                      fe_s_v_mapped_point_A.reinit(cell_s);
+                }
 
-                      up_field.compute_point_locations (fe_s_v_mapped_point_A.get_quadrature_points(),
-                                                        fluid_cells,
-                                                        fluid_qpoints,
-                                                        fluid_maps);
+            }//if face of solid cell is not on the cylinder
+        }//End loop over boundary faces of solid cells
 
-                      Assert(fluid_cells.size() == 1, ExcMessage("Mapped point A found in multiple fluid cells!"));
-                      Quadrature<dim> quad_bg (fluid_qpoints[0]);
+      //--------------------------------------------------------------//
+      //-------        CALCULATION OF PRESSURE AT POINT A ------------//
+      //--------------------------------------------------------------//
+      //Calculate the pressure at point A & the viscous stress (if any)
+      {
+        fe_s_v_mapped_point_A.reinit(cell_having_point_A);
 
-                      FEValues<dim> fe_v_bg (fe_f, quad_bg,
-                                             update_values | update_gradients);
-                      fe_v_bg.reinit(fluid_cells[0]);
+        up_field.compute_point_locations (fe_s_v_mapped_point_A.get_quadrature_points(),
+                                          fluid_cells,
+                                          fluid_qpoints,
+                                          fluid_maps);
 
-                      //Localize the solution for the obtained fluid cell...but before that, resize the vectors
-                      sol_f.resize(1, Vector <double> (dim+1));
+        Assert(fluid_cells.size() == 1, ExcMessage("Mapped point A found in multiple fluid cells!"));
+        Quadrature<dim> quad_bg (fluid_qpoints[0]);
 
-                      fe_v_bg.get_function_values (current_xi.block(0), sol_f);
-                      pressure_A = sol_f[0](dim);
+        FEValues<dim> fe_v_bg (fe_f, quad_bg,
+                               update_values | update_gradients);
+        fe_v_bg.reinit(fluid_cells[0]);
 
-                    }
+        //Localize the solution for the obtained fluid cell...but before that, resize the vectors
+        sol_f.resize(1, Vector <double> (dim+1));
 
-                }//if face of solid cell is at the boundary
-            }//loop over faces of solid cells
-        }//End loop over solid cells
+        fe_v_bg.get_function_values (current_xi.block(0), sol_f);
+        pressure_A = sol_f[0](dim);
+      }
     }//For FSI test only
 
   fsi_bm_out_file.unsetf(ios_base::floatfield);
@@ -3731,7 +4640,7 @@ void IFEM<dim>::fsi_bm_postprocess()
 
 //         }
 
-//       M_gamma3_inv.solve(tmp_vec_n_dofs_W);
+//       M_gamma3_inv->solve(tmp_vec_n_dofs_W);
 
 // //The actual calculations of the drag and the lift on the flag are done in the
 // //following section of the code:
@@ -3933,14 +4842,11 @@ template <int dim>
 void IFEM<dim>::fsi_bm_postprocess2()
 {
   //: Some geometric features of the benchmark test(s)
-  const Point<dim> center_cyl (0.2, 0.2); //: Center of the cylinder
   const double D_cyl = 0.1; //: Diameter of the cylinder
   const double H = 0.41; //: Height of the channel
-  const double l_flag = 0.35; //: Length of the flag
 
-  //Compute the the displacement of the pt. A (i.e. the midpt of the end of the tail)
-  Point<dim> point_A (center_cyl[0]+0.5*D_cyl+l_flag, center_cyl[1]);
-  Point<dim> point_B (center_cyl[0]-0.5*D_cyl, center_cyl[1]);
+  //Compute the the displacement of the pt. A (i.e. the midpt of the end of the tail).
+  //Points A and B are located once and for all by initialize_probes().
   Vector<double> disp_A (dim);
   Vector<double> sol_B (dim+1);
   double pressure_A = 0.0;
@@ -3953,14 +4859,8 @@ void IFEM<dim>::fsi_bm_postprocess2()
   if (par.cfd_test)
     {
       //: Point A now corresponds to midpoint of the aft edge of the cylinder
-      point_A[0] -= l_flag;
-
       //: Extract the value of pressure at point A
-      VectorTools::point_value(dh_f,
-                               current_xi.block(0),
-                               point_A,
-                               sol_B);
-      pressure_A = sol_B(dim);
+      pressure_A = probe_A.value(current_xi.block(0), dim);
 
       //: Evaluate the average value of the inflow velocity for t=4s for CFDBM1-3
       par.u_g.set_time(4.0);
@@ -3969,15 +4869,9 @@ void IFEM<dim>::fsi_bm_postprocess2()
 
     }
   else
-    VectorTools::point_value(dh_s,
-                             current_xi.block(1),
-                             point_A,
-                             disp_A);
+    probe_A.value(current_xi.block(1), disp_A);
 
-  VectorTools::point_value(dh_f,
-                           current_xi.block(0),
-                           point_B,
-                           sol_B);
+  probe_B.value(current_xi.block(0), sol_B);
 
   //-------------------- Loop over FLUID CELLS-----------------//
   //Calculating the drag and lift values corresponding to the free surface of the cylinder
@@ -4051,37 +4945,39 @@ void IFEM<dim>::fsi_bm_postprocess2()
                   * fe_f_v.JxW(q);
             }
         }
+    }//loop over cells
 
-      //: Surface integration over all the boundaries of the control volume
-      // EXCEPT those comprising the cylinder + the flag
-      for (unsigned int face=0; face < GeometryInfo<dim>::faces_per_cell; ++face)
-        {
-          if (cell->face(face)->at_boundary()
-              && (cell->face(face)->manifold_id() < 80)
-             )
-            {
-              fe_f_face_v.reinit (cell, face);
+  //: Surface integration over all the boundaries of the control volume
+  // EXCEPT those comprising the cylinder + the flag
+  const vector<typename GeometryCache<dim>::CellFace> &faces
+    = fluid_geometry.boundary_faces;
+  for (unsigned int b=0; b<faces.size(); ++b)
+    {
+      const typename DoFHandler<dim,dim>::active_cell_iterator &cell = faces[b].first;
+      const unsigned int face = faces[b].second;
 
-              fe_f_face_v.get_function_values (current_xi.block(0), sol_f_face);
-              fe_f_face_v.get_function_gradients (current_xi.block(0), sol_grad_f_face);
+      if (cell->face(face)->manifold_id() < 80)
+        {
+          fe_f_face_v.reinit (cell, face);
 
-              for (unsigned int q = 0; q < n_qpf_face; ++q) //loop over quadrature pts
-                {
-                  for (unsigned int i = 0; i < dim; ++i) //loop over dim
-                    for (unsigned int j = 0; j < dim; ++j) //loop over dim
-                      drag_lift[i] += //(T_f - p I)*(n da)
-                        (par.eta_f
-                         *(sol_grad_f_face[q][i][j]
-                           + sol_grad_f_face[q][j][i])
-                         - (i == j ? sol_f_face[q](dim) : 0.0)
-                        )
-                        *(fe_f_face_v.normal_vector(q)[j])
-                        *fe_f_face_v.JxW(q);
-                }//loop over q
-            }//if cond.
-        }//loop over faces
+          fe_f_face_v.get_function_values (current_xi.block(0), sol_f_face);
+          fe_f_face_v.get_function_gradients (current_xi.block(0), sol_grad_f_face);
 
-    }//loop over cells
+          for (unsigned int q = 0; q < n_qpf_face; ++q) //loop over quadrature pts
+            {
+              for (unsigned int i = 0; i < dim; ++i) //loop over dim
+                for (unsigned int j = 0; j < dim; ++j) //loop over dim
+                  drag_lift[i] += //(T_f - p I)*(n da)
+                    (par.eta_f
+                     *(sol_grad_f_face[q][i][j]
+                       + sol_grad_f_face[q][j][i])
+                     - (i == j ? sol_f_face[q](dim) : 0.0)
+                    )
+                    *(fe_f_face_v.normal_vector(q)[j])
+                    *fe_f_face_v.JxW(q);
+            }//loop over q
+        }//if cond.
+    }//loop over faces
 
   ///-------------------- Loop over FLUID CELLS (end)-----------------//
   if (par.cfd_test && (abs(U_avg)>1e-8))
@@ -4091,16 +4987,11 @@ void IFEM<dim>::fsi_bm_postprocess2()
     }
   else //: if the regular FSI BM test is being performed
     {
-      //We find the solid cell in which point A resides and then
-      //associate a quadrature point with point A. Note a quadrature point can only
+      //The solid cell in which point A resides is known from its probe, and
+      //we associate a quadrature point with point A. Note a quadrature point can only
       //lie in a unit cell.
-      const pair<typename DoFHandler<dim, dim>::active_cell_iterator, Point<dim> > cell_and_point
-        = GridTools::find_active_cell_around_point (StaticMappingQ1<dim, dim>::mapping,
-                                                    dh_s,
-                                                    point_A);
-
-      typename DoFHandler<dim, dim>::active_cell_iterator cell_having_point_A = cell_and_point.first;
-      Point<dim> unit_cell_point_A = GeometryInfo<dim>::project_to_unit_cell(cell_and_point.second);
+      const typename DoFHandler<dim, dim>::active_cell_iterator cell_having_point_A = probe_A.cell;
+      const Point<dim> unit_cell_point_A = probe_A.unit_point;
 
 
       Quadrature<dim> quad_point_A (unit_cell_point_A);
@@ -4228,35 +5119,33 @@ void IFEM<dim>::fsi_bm_postprocess2()
 
             }
 
-          //--------------------------------------------------------------//
-          //-------        CALCULATION OF PRESSURE AT POINT A ------------//
-          //--------------------------------------------------------------//
-          //Calculate the pressure at point A & the viscous stress (if any)
-          if (cell_s == cell_having_point_A)
-            {
-              fe_s_v_mapped_point_A.reinit(cell_s);
-
-              up_field.compute_point_locations (fe_s_v_mapped_point_A.get_quadrature_points(),
-                                                fluid_cells,
-                                                fluid_qpoints,
-                                                fluid_maps);
+        }//End loop over solid cells
 
-              Assert(fluid_cells.size() == 1, ExcMessage("Mapped point A found in multiple fluid cells!"));
-              Quadrature<dim> quad_bg (fluid_qpoints[0]);
+      //--------------------------------------------------------------//
+      //-------        CALCULATION OF PRESSURE AT POINT A ------------//
+      //--------------------------------------------------------------//
+      //Calculate the pressure at point A & the viscous stress (if any)
+      {
+        fe_s_v_mapped_point_A.reinit(cell_having_point_A);
 
-              FEValues<dim> fe_v_bg (fe_f, quad_bg,
-                                     update_values | update_gradients);
-              fe_v_bg.reinit(fluid_cells[0]);
+        up_field.compute_point_locations (fe_s_v_mapped_point_A.get_quadrature_points(),
+                                          fluid_cells,
+                                          fluid_qpoints,
+                                          fluid_maps);
 
-              //Localize the solution for the obtained fluid cell...but before that, resize the vectors
-              sol_f.resize(1, Vector <double> (dim+1));
+        Assert(fluid_cells.size() == 1, ExcMessage("Mapped point A found in multiple fluid cells!"));
+        Quadrature<dim> quad_bg (fluid_qpoints[0]);
 
-              fe_v_bg.get_function_values (current_xi.block(0), sol_f);
-              pressure_A = sol_f[0](dim);
+        FEValues<dim> fe_v_bg (fe_f, quad_bg,
+                               update_values | update_gradients);
+        fe_v_bg.reinit(fluid_cells[0]);
 
-            }
+        //Localize the solution for the obtained fluid cell...but before that, resize the vectors
+        sol_f.resize(1, Vector <double> (dim+1));
 
-        }//End loop over solid cells
+        fe_v_bg.get_function_values (current_xi.block(0), sol_f);
+        pressure_A = sol_f[0](dim);
+      }
 
     }//For FSI test only
   fsi_bm_out_file.unsetf(ios_base::floatfield);
@@ -4288,9 +5177,188 @@ void IFEM<dim>::serialize(Archive &ar, const unsigned int version)
 }
 
 
+// Complete state of the computation, as stored in the binary
+// checkpoint: the triangulation of the control volume and the numbering
+// of its dofs, if it is remeshed during the run, the data of the
+// temporal integration, both vectors of the state, the counters of the
+// Newton iteration and, if requested, the fluid and solid blocks of the
+// sparsity pattern of the Jacobian. Whenever this changes,
+// <code>checkpoint_format_version</code> must be increased.
+//
+// The triangulation comes first, in an archive of its own, since it is
+// needed before the dofs are distributed: it is read by
+// <code>restore_fluid_mesh</code>, and skipped here.
+
+template <int dim>
+template <class Archive>
+void IFEM<dim>::serialize_state (Archive &ar)
+{
+  string fluid_mesh;
+  if (!Archive::is_loading::value && par.remesh_interval_f > 0)
+    {
+      vector<types::global_dof_index> numbering;
+      final_dof_numbering (dh_f, numbering);
+
+      ostringstream data;
+      {
+        boost::archive::binary_oarchive oa (data);
+        oa << tria_f << numbering;
+      }
+      fluid_mesh = data.str();
+    }
+  ar &fluid_mesh;
+
+  serialize (ar, checkpoint_format_version);
+  ar &previous_time;
+
+  for (unsigned int b=0; b<current_xi.n_blocks(); ++b)
+    {
+      ar &current_xi.block(b);
+      ar &previous_xi.block(b);
+    }
+  if (Archive::is_loading::value)
+    {
+      current_xi.collect_sizes ();
+      previous_xi.collect_sizes ();
+    }
+
+  ar &newton_policy;
+
+  bool with_sparsity = par.checkpoint_sparsity && !par.jacobian_free;
+  ar &with_sparsity;
+  if (Archive::is_loading::value)
+    sparsity_from_checkpoint = with_sparsity;
+
+  if (with_sparsity)
+    {
+      if (Archive::is_loading::value)
+        sparsity.reinit (2, 2);
+      ar &sparsity.block(0,0);
+      ar &sparsity.block(1,1);
+
+// The coupling blocks are left empty, with the right sizes, until
+// <code>assemble_sparsity</code> is called.
+      if (Archive::is_loading::value)
+        {
+          sparsity.block(0,1).reinit (sparsity.block(0,0).n_rows(),
+                                      sparsity.block(1,1).n_cols(),
+                                      0);
+          sparsity.block(1,0).reinit (sparsity.block(1,1).n_rows(),
+                                      sparsity.block(0,0).n_cols(),
+                                      0);
+          sparsity.collect_sizes ();
+        }
+    }
+}
+
+
+// On restart, the most recent complete checkpoint that can be read is
+// used; one that is damaged is reported and skipped in favor of the
+// previous one. This choice is made before the triangulations are
+// built, since the checkpoint may hold the triangulation of the control
+// volume: if so, it is restored here, with the numbering of its dofs,
+// and the function returns true.
+
+template <int dim>
+bool IFEM<dim>::restore_fluid_mesh ()
+{
+  restart_checkpoint.clear ();
+  string().swap (restart_data);
+
+  const vector<string> checkpoints
+    = complete_checkpoints (par.output_name + par.file_info_for_restart);
+
+  for (unsigned int i=checkpoints.size(); i>0; --i)
+    {
+      try
+        {
+          restart_data = read_checkpoint (checkpoints[i-1]);
+          restart_checkpoint = checkpoints[i-1];
+          break;
+        }
+      catch (const std::exception &exc)
+        {
+          cerr
+              << " Skipping the checkpoint "
+              << checkpoints[i-1]
+              << ": "
+              << exc.what()
+              << endl;
+        }
+    }
+  AssertThrow (checkpoints.empty() || !restart_checkpoint.empty(),
+               ExcMessage ("None of the checkpoints could be read."));
+
+  if (restart_checkpoint.empty())
+    return false;
+
+  string fluid_mesh;
+  {
+    istringstream data (restart_data);
+    boost::archive::binary_iarchive ia (data);
+    ia >> fluid_mesh;
+  }
+  if (fluid_mesh.empty())
+    return false;
+
+  istringstream data (fluid_mesh);
+  boost::archive::binary_iarchive ia (data);
+  ia >> tria_f >> restored_numbering_f;
+
+  cout
+      << " Control volume restored from "
+      << restart_checkpoint
+      << ": "
+      << tria_f.n_active_cells()
+      << " cells"
+      << endl;
+  return true;
+}
+
+
+// The state is read from the checkpoint chosen by
+// <code>restore_fluid_mesh</code>. Without checkpoints, the files
+// written by earlier versions of the code, holding only the data of
+// the temporal integration and the current state, are used.
+
 template <int dim>
 void IFEM<dim>::restart_computations()
 {
+  if (par.restart_step >= 0)
+    {
+      restart_from_frame ();
+      return;
+    }
+
+  if (!restart_checkpoint.empty())
+    {
+      Timer timer;
+      {
+        istringstream data (restart_data);
+        boost::archive::binary_iarchive ia (data);
+        serialize_state (ia);
+      }
+      string().swap (restart_data);
+
+      AssertThrow (previous_xi.size() == n_total_dofs,
+                   ExcMessage ("The checkpoint " + restart_checkpoint
+                               + " does not match the dofs of this computation."));
+
+      cout
+          << " Restarting from "
+          << restart_checkpoint
+          << " at t = "
+          << current_time
+          << " (read in "
+          << timer.wall_time()
+          << " s)"
+          << endl;
+
+      if (par.save_for_restart)
+        checkpoint_writer.restored (restart_checkpoint);
+      return;
+    }
+
   // Load the details concerning the temporal integration.
   //Currently we are reading in: current_time, timestep and dt
   ifstream ifs((par.output_name
@@ -4328,61 +5396,110 @@ void IFEM<dim>::restart_computations()
 
 }
 
+// Restart from the solution frames written by <code>output_step</code> at
+// the step <code>par.restart_step</code>, whose time and time step size
+// are found in the index of the frames. If the same step appears more
+// than once, because the run that wrote the frames was itself restarted,
+// the last entry is the one of the frames on disk. The implicit Euler
+// method only needs the solution at that step: it becomes the previous
+// state of the first new step.
+
 template <int dim>
-void IFEM<dim>::save_for_restart()
+void IFEM<dim>::restart_from_frame ()
 {
-  // Assumption is that if the initial time is 0 then this the first time that this
-  // computation
-  if (par.this_is_a_restart)
+  const string index_name = par.restart_frames_name + "_steps.txt";
+  ifstream index (index_name.c_str());
+  AssertThrow (index, ExcMessage ("Can't open the index of the frames "
+                                  + index_name + "."));
+
+  bool found = false;
+  string line;
+  while (getline (index, line))
     {
-      // "if we have previously written a snapshot, then keep the last
-      // snapshot in case this one fails to save" --- ASPECT checkpoint_restart.cc
-      move_file (par.output_name
-                 + par.file_info_for_restart
-                 + "resume.txt",
-                 par.output_name
-                 + par.file_info_for_restart
-                 + "resume.txt.old");
-      move_file (par.output_name + par.file_info_for_restart + "xi.bin",
-                 par.output_name + par.file_info_for_restart + "xi.bin.old");
-//    move_file (par.output_name + par.file_info_for_restart + "prev_xi.bin",
-//                  par.output_name + par.file_info_for_restart + "prev_xi.bin.old");
+      if (line.empty() || line[0] == '#')
+        continue;
+      istringstream entry (line);
+      int step;
+      double t, h;
+      if ((entry >> step >> t >> h) && step == par.restart_step)
+        {
+          found = true;
+          current_time = t;
+          dt = h;
+        }
     }
+  AssertThrow (found,
+               ExcMessage ("The step " + Utilities::int_to_string (par.restart_step)
+                           + " is not recorded in " + index_name + "."));
 
-  // Load the details concerning the temporal integration.
-  std::ofstream ofs ((par.output_name
-                      + par.file_info_for_restart
-                      + "resume.txt").c_str());
-  boost::archive::text_oarchive oa_time (ofs);
-  oa_time << (*this);
-  ofs.close();
+  const string step_name = Utilities::int_to_string (par.restart_step, 5);
+  const string fluid_name = par.restart_frames_name + "-fluid-" + step_name + ".bin";
+  const string solid_name = par.restart_frames_name + "-solid-" + step_name + ".bin";
 
+  ifstream fluid_frame (fluid_name.c_str());
+  AssertThrow (fluid_frame, ExcMessage ("Can't open the frame " + fluid_name + "."));
+  previous_xi.block(0).block_read (fluid_frame);
 
-  // Load the vector storing the current solution.
-//  tmp_vec_n_total_dofs = current_xi;
-//  tmp_vec_n_total_dofs.save ((par.file_info_for_restart + "_xi.txt").c_str());
+  ifstream solid_frame (solid_name.c_str());
+  AssertThrow (solid_frame, ExcMessage ("Can't open the frame " + solid_name + "."));
+  previous_xi.block(1).block_read (solid_frame);
 
-  // Load the vector storing the previous solution.
-//  tmp_vec_n_total_dofs = previous_xi;
-//  tmp_vec_n_total_dofs.save ((par.file_info_for_restart + "_previous_xi.txt").c_str());
+  AssertThrow (previous_xi.block(0).size() == n_dofs_up
+               &&
+               previous_xi.block(1).size() == n_dofs_W,
+               ExcMessage ("The frames of step " + step_name + " do not match "
+                           "the dofs of this computation."));
 
-  ofstream fname_xi((par.output_name + par.file_info_for_restart + "xi.bin").c_str());
-  tmp_vec_n_total_dofs = current_xi;
-  tmp_vec_n_total_dofs.block_write(fname_xi);
-  fname_xi.close();
+  previous_time = current_time;
+  time_step = par.restart_step;
 
+  cout
+      << " Restarting from the frames of step "
+      << step_name
+      << " at t = "
+      << current_time
+      << endl;
+}
 
-//   ofstream fname_prev_xi((par.output_name
-//                         + par.file_info_for_restart
-//                         + "prev_xi.bin").c_str());
-//
-//   tmp_vec_n_total_dofs = previous_xi;
-//   tmp_vec_n_total_dofs.block_write(fname_prev_xi);
-//   fname_prev_xi.close();
 
-  // ifstream fname("test_vec_out.bin");
-  //test_bvec.block_read(fname);
+// The state is written into a binary archive in memory, which is the
+// snapshot handed to <code>checkpoint_writer</code>. The latter writes
+// it into a checkpoint file, with its header and checksum, possibly in
+// the background, and removes the oldest checkpoints.
+
+template <int dim>
+void IFEM<dim>::save_for_restart()
+{
+  string snapshot;
+  {
+    ostringstream data;
+    {
+      boost::archive::binary_oarchive oa (data);
+      serialize_state (oa);
+    }
+    snapshot = data.str();
+  }
+  checkpoint_writer.write (time_step, snapshot);
+  checkpoint_timer.restart ();
+}
+
+
+// Whether a checkpoint must be written at the end of the current step.
+
+template <int dim>
+bool IFEM<dim>::checkpoint_due () const
+{
+  if (!par.save_for_restart)
+    return false;
+
+  if (par.checkpoint_step_interval > 0
+      &&
+      time_step % par.checkpoint_step_interval == 0)
+    return true;
 
+  return (par.checkpoint_minutes > 0
+          &&
+          checkpoint_timer.wall_time() >= 60*par.checkpoint_minutes);
 }
 
 // Simple initialization to zero function templated on a generic type.
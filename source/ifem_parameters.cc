@@ -1,7 +1,36 @@
 #include "ifem_parameters.h"
+#include "direct_solver.h"
+#include "dof_ordering.h"
 #include <iostream>
 #include <fstream>
 
+namespace
+{
+// Parse a list of points of the form "(x, y); (x, y)".
+  template <int dim>
+  vector<Point<dim> > parse_point_list (const string &list)
+  {
+    vector<Point<dim> > points;
+    const vector<string> items = Utilities::split_string_list(list, ';');
+    for (unsigned int i=0; i<items.size(); ++i)
+      {
+        string item = items[i];
+        if (!item.empty() && item[0] == '(')
+          item = item.substr(1, item.size()-2);
+        const vector<double> coords
+          = Utilities::string_to_double(Utilities::split_string_list(item, ','));
+        AssertThrow(coords.size() == dim,
+                    ExcDimensionMismatch(coords.size(), dim));
+
+        Point<dim> p;
+        for (unsigned int d=0; d<dim; ++d)
+          p[d] = coords[d];
+        points.push_back(p);
+      }
+    return points;
+  }
+}
+
 // Class constructor: the name of the input file is
 // <code>immersed_fem.prm</code>. If the file does not exist at run time, it
 // is created, and the simulation parameters are given default values.
@@ -12,8 +41,8 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   u_0(dim+1),
   u_g(dim+1),
   force(dim+1),
-  component_mask(dim+1, true)
-  //,pt_source_strength(1)
+  component_mask(dim+1, true),
+  pt_source_shared_strength(1)
 {
 
 // Declaration of parameters for the ParsedFunction objects
@@ -52,6 +81,85 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
     "false",
     Patterns::Bool()
   );
+  this->declare_entry (
+    "Jacobian refresh policy",
+    "Legacy",
+    Patterns::Selection ("Legacy|Contraction rate"),
+    "Legacy: refresh the Jacobian after an update computed from a residual "
+    "larger than 1e-2 and every 10 iterations. Contraction rate: refresh "
+    "it only when the ratio of two successive residual norms exceeds "
+    "\"Jacobian refresh contraction\"."
+  );
+  this->declare_entry (
+    "Jacobian refresh contraction",
+    "0.5",
+    Patterns::Double (0., 1.)
+  );
+  this->declare_entry ("Newton absolute tolerance", "1e-10", Patterns::Double (0.));
+  this->declare_entry (
+    "Newton relative tolerance",
+    "0.",
+    Patterns::Double (0.),
+    "Tolerance relative to the first residual of each time step."
+  );
+  this->declare_entry ("Maximum Newton iterations", "40", Patterns::Integer (1));
+  this->declare_entry (
+    "Linear solver",
+    "Direct",
+    Patterns::Selection ("Direct|GMRES|JFNK"),
+    "Direct: compute the Newton updates with the last factorization of "
+    "the Jacobian. GMRES: solve with the current Jacobian, using the last "
+    "factorization as preconditioner, up to the relative accuracy given "
+    "by the forcing term. JFNK: as GMRES, but the action of the Jacobian "
+    "is approximated by finite differences of the residual, and the "
+    "preconditioner only uses the fluid block of the Jacobian and the "
+    "mass matrix of the immersed domain."
+  );
+  this->declare_entry (
+    "Direct solver",
+    default_direct_solver(),
+    Patterns::Selection (direct_solver_names()),
+    "Sparse direct solver used to factorize the Jacobian and the mass "
+    "matrix of the immersed domain. UMFPACK and the solvers of Trilinos "
+    "(Amesos) are listed if deal.II was configured with them."
+  );
+  this->declare_entry (
+    "Factorization ordering",
+    "Automatic",
+    Patterns::Selection (direct_solver_ordering_names()),
+    "Ordering of the columns of the Jacobian for its factorization. "
+    "Automatic, AMD and METIS are computed by UMFPACK, Natural keeps the "
+    "dof numbering. Block interleaved mixes velocity and pressure dofs; "
+    "Joint fluid-solid places each displacement dof next to the first "
+    "fluid dof it is coupled to. Cell-local pressure, for a discontinuous "
+    "pressure only, places the pressure dofs of each cell right after "
+    "its velocity dofs. Other solvers ignore this entry."
+  );
+  this->declare_entry (
+    "Dof renumbering",
+    "Cuthill-McKee",
+    Patterns::Selection (dof_renumbering_names()),
+    "Renumbering of the dofs of the control volume and of the immersed "
+    "domain, applied before sorting the former by component."
+  );
+  this->declare_entry (
+    "Krylov operator",
+    "Assembled Jacobian",
+    Patterns::Selection ("Assembled Jacobian|Finite differences"),
+    "Operator of GMRES when the Linear solver is GMRES: either the "
+    "Jacobian assembled at every iteration, or finite differences of the "
+    "residual. In both cases GMRES is only used when the factorization of "
+    "the Jacobian is out of date; otherwise the update is computed "
+    "directly."
+  );
+  this->declare_entry (
+    "Forcing term",
+    "Eisenstat-Walker",
+    Patterns::Selection ("Constant|Eisenstat-Walker")
+  );
+  this->declare_entry ("Initial forcing term", "0.1", Patterns::Double (0., 1.));
+  this->declare_entry ("Maximum forcing term", "0.9", Patterns::Double (0., 1.));
+  this->declare_entry ("Maximum linear iterations", "200", Patterns::Integer (1));
   this->declare_entry ("Fluid density", "1", Patterns::Double());
   this->declare_entry ("Solid density", "1", Patterns::Double());
   this->declare_entry ("Fluid viscosity", "1", Patterns::Double());
@@ -61,6 +169,17 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   this->declare_entry ("Phi_B", "1", Patterns::Double());
   this->declare_entry ("Semi-implicit scheme", "true", Patterns::Bool());
   this->declare_entry ("Fix one dof of p", "false", Patterns::Bool());
+  this->declare_entry (
+    "Pressure constraint",
+    "Dense row",
+    Patterns::Selection ("Dense row|Projection"),
+    "With Dirichlet boundary conditions everywhere, how the average "
+    "pressure is set to zero. Dense row replaces the equation of the "
+    "first pressure dof by the average pressure, which couples it to all "
+    "other pressure dofs in the Jacobian. Projection keeps only the "
+    "diagonal of that row, and removes the average from the pressure "
+    "after every Newton update."
+  );
   this->declare_entry (
     "Solid mesh",
     "mesh/solid_square.inp",
@@ -72,8 +191,26 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
     Patterns::Anything()
   );
   this->declare_entry ("Output base name", "out/square", Patterns::Anything());
+  this->declare_entry (
+    "Setup cache directory",
+    "",
+    Patterns::Anything(),
+    "Directory where the refined meshes, the numbering of the dofs and the "
+    "sparsity patterns are saved, to be restored by later runs with the "
+    "same mesh files and discretization. Leave empty to disable the cache."
+  );
   this->declare_entry ("Dirichlet BC indicator", "1", Patterns::Integer(0,254));
   this->declare_entry ("All Dirichlet BC", "true", Patterns::Bool());
+  this->declare_entry (
+    "Boundary data are separable",
+    "false",
+    Patterns::Bool(),
+    "Declare that the boundary data ug are of the form g(t) u(x). The "
+    "profile u(x) is then evaluated once, and only g(t) at each time "
+    "step. A single additional value per step is used as a sanity check: "
+    "it does not make it safe to set this for data that are not "
+    "separable."
+  );
   this->declare_entry (
     "Interval (of time-steps) between output",
     "1",
@@ -163,28 +300,95 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
                       "0",
                       Patterns::Integer(),
                       "It is recommended that FE_Q be used for your simulation"
-                      "when source strength is non-zero.");
+                      "when source strength is non-zero. At most "
+                      + Utilities::int_to_string(max_listed_point_sources)
+                      + " sources can be listed here.");
   this->declare_entry("List of location(s) of point source(s):",
                       "(0.5, 0.5)",
                       Patterns::Anything(),
                       "Items of this list are separated using semi-colon.");
   //:
-  this->enter_subsection("Strength of point source no.1");
-  ParsedFunction<dim>::declare_parameters(*this, 1);
-  this->leave_subsection();
+  for (unsigned int i=0; i<max_listed_point_sources; ++i)
+    {
+      this->enter_subsection("Strength of point source no." + Utilities::int_to_string(i+1));
+      ParsedFunction<dim>::declare_parameters(*this, 1);
+      this->leave_subsection();
+    }
 
-  this->enter_subsection("Strength of point source no.2");
-  ParsedFunction<dim>::declare_parameters(*this, 1);
-  this->leave_subsection();
+  this->declare_entry("Point source file",
+                      "",
+                      Patterns::Anything(),
+                      "File with additional point sources, one per line: "
+                      "the coordinates of the source followed, optionally, "
+                      "by a factor multiplying its strength. Lines starting "
+                      "with # are ignored.");
+  this->declare_entry("Strength of sources in file",
+                      "Shared expression",
+                      Patterns::Selection("Shared expression|Time series"),
+                      "Strength of the sources read from the point source "
+                      "file, before the multiplication by their factors: "
+                      "either the function of space and time of the "
+                      "subsection \"Shared strength of point sources\", or "
+                      "the function of time tabulated in the strength time "
+                      "series file.");
+  this->declare_entry("Strength time series file",
+                      "",
+                      Patterns::Anything(),
+                      "File with two columns, time and strength. The "
+                      "strength is interpolated linearly in time.");
 
-  this->enter_subsection("Strength of point source no.3");
+  this->enter_subsection("Shared strength of point sources");
   ParsedFunction<dim>::declare_parameters(*this, 1);
   this->leave_subsection();
+  //:
+  this->leave_subsection();
 
-  this->enter_subsection("Strength of point source no.4");
-  ParsedFunction<dim>::declare_parameters(*this, 1);
+  this->enter_subsection("Probes");
+  this->declare_entry("Fluid probe points",
+                      "",
+                      Patterns::Anything(),
+                      "Points at which velocity and pressure are written at "
+                      "every time step. Items of this list are separated "
+                      "using semi-colon, e.g. (0.5, 0.5); (0.25, 0.5).");
+  this->declare_entry("Solid probe points",
+                      "",
+                      Patterns::Anything(),
+                      "Points of the reference configuration of the immersed "
+                      "domain at which the displacement is written at every "
+                      "time step. Same format as the fluid probe points.");
   this->leave_subsection();
-  //:
+
+  this->enter_subsection("Adaptive fluid refinement");
+  this->declare_entry("Number of cycles",
+                      "0",
+                      Patterns::Integer(0),
+                      "Cycles of local refinement of the control volume, "
+                      "applied after the global one. Each cycle refines the "
+                      "fluid cells containing quadrature points of the "
+                      "immersed domain, the buffer around them, and the cells "
+                      "flagged by the Kelly estimator.");
+  this->declare_entry("Buffer layers",
+                      "1",
+                      Patterns::Integer(0),
+                      "Layers of fluid cells around the immersed domain "
+                      "that are refined along with the cells containing it.");
+  this->declare_entry("Kelly fraction",
+                      "0.",
+                      Patterns::Double(0., 1.),
+                      "Fraction of the fluid cells, those with the largest "
+                      "Kelly indicator of the velocity of the initial "
+                      "conditions, that are refined in each cycle.");
+  this->declare_entry("Remeshing interval (time steps)",
+                      "0",
+                      Patterns::Integer(0),
+                      "Time steps between two checks of the position of the "
+                      "immersed domain. If it is no longer contained in the "
+                      "finest fluid cells, the control volume is refined "
+                      "around its current position, with the Kelly indicator "
+                      "of the current velocity, and coarsened elsewhere. "
+                      "Zero disables the remeshing. The remeshed control "
+                      "volume is saved in the checkpoints, from which a "
+                      "restart must then start.");
   this->leave_subsection();
 
   this->declare_entry("Time-dependent Stokes flow","false",Patterns::Bool());
@@ -234,6 +438,46 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   this->declare_entry ("File prefix used for files needed for restart",
                        "-restart-",
                        Patterns::Anything());
+  this->declare_entry ("Save sparsity pattern for restart",
+                       "false",
+                       Patterns::Bool(),
+                       "Store the fluid and solid blocks of the sparsity "
+                       "pattern of the Jacobian in the checkpoint. This makes "
+                       "the file larger, but a restart only computes the "
+                       "coupling blocks again.");
+  this->declare_entry ("Checkpoint interval (time steps)",
+                       "0",
+                       Patterns::Integer (0),
+                       "Write a checkpoint every so many time steps. With 0, "
+                       "the number of steps does not trigger checkpoints.");
+  this->declare_entry ("Checkpoint interval (minutes)",
+                       "0",
+                       Patterns::Double (0),
+                       "Write a checkpoint when so many minutes of wall "
+                       "clock time have passed since the last one. With 0, "
+                       "time does not trigger checkpoints.");
+  this->declare_entry ("Number of checkpoints to keep",
+                       "2",
+                       Patterns::Integer (1));
+  this->declare_entry ("Write checkpoints in the background",
+                       "true",
+                       Patterns::Bool(),
+                       "Write the checkpoints with a separate task, while "
+                       "the computation continues from the next step.");
+  this->declare_entry ("Restart from step",
+                       "-1",
+                       Patterns::Integer (-1),
+                       "In a restart, start from the solution written at "
+                       "this step, as recorded in the files -fluid-NNNNN.bin "
+                       "and -solid-NNNNN.bin and in the index _steps.txt, "
+                       "instead of from a checkpoint. A negative value "
+                       "restarts from the last checkpoint.");
+  this->declare_entry ("Base name of restart frames",
+                       "",
+                       Patterns::Anything(),
+                       "Output base name of the run whose frames are used "
+                       "by \"Restart from step\". If empty, the output base "
+                       "name of this run.");
 
   this->leave_subsection();
 
@@ -288,6 +532,25 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   update_jacobian_at_step_beginning = this->get_bool (
                                         "Force J update at step beginning"
                                       );
+  adaptive_jacobian_refresh
+    = (this->get ("Jacobian refresh policy") == "Contraction rate");
+  jacobian_refresh_contraction = this->get_double ("Jacobian refresh contraction");
+  newton_absolute_tolerance = this->get_double ("Newton absolute tolerance");
+  newton_relative_tolerance = this->get_double ("Newton relative tolerance");
+  max_newton_iterations = this->get_integer ("Maximum Newton iterations");
+  iterative_linear_solver = (this->get ("Linear solver") != "Direct");
+  jacobian_free = (this->get ("Linear solver") == "JFNK");
+  direct_solver = this->get ("Direct solver");
+  factorization_ordering = this->get ("Factorization ordering");
+  dof_renumbering = this->get ("Dof renumbering");
+  finite_difference_operator
+    = ((this->get ("Linear solver") == "GMRES")
+       &&
+       (this->get ("Krylov operator") == "Finite differences"));
+  eisenstat_walker = (this->get ("Forcing term") == "Eisenstat-Walker");
+  initial_forcing_term = this->get_double ("Initial forcing term");
+  max_forcing_term = this->get_double ("Maximum forcing term");
+  max_linear_iterations = this->get_integer ("Maximum linear iterations");
 
   rho_f = this->get_double ("Fluid density");
   rho_s = this->get_double ("Solid density");
@@ -305,13 +568,16 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
 
   semi_implicit = this->get_bool ("Semi-implicit scheme");
   fix_pressure = this->get_bool ("Fix one dof of p");
+  project_pressure = (this->get ("Pressure constraint") == "Projection");
 
   solid_mesh = this->get ("Solid mesh");
   fluid_mesh = this->get ("Fluid mesh");
+  setup_cache_directory = this->get ("Setup cache directory");
   output_name = this->get ("Output base name");
 
   unsigned char id = this->get_integer ("Dirichlet BC indicator");
   all_DBC = this->get_bool ("All Dirichlet BC");
+  separable_bc = this->get_bool ("Boundary data are separable");
   output_interval = this->get_integer (
                       "Interval (of time-steps) between output"
                     );
@@ -387,6 +653,12 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   //:
   n_pt_source = this->get_integer("Number of point sources present");
   cout<<"No. of pts ="<<n_pt_source<<endl;
+  AssertThrow(n_pt_source <= max_listed_point_sources,
+              ExcMessage("At most "
+                         + Utilities::int_to_string(max_listed_point_sources)
+                         + " point sources can be listed in the parameter "
+                           "file; use the point source file, with a factor "
+                           "of the strength on each line, for more."));
 
   if (n_pt_source)
     {
@@ -422,8 +694,36 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
           this->enter_subsection("Strength of point source no." + Utilities::int_to_string(i+1));
           pt_source_strength[i]->parse_parameters(*this);
           this->leave_subsection();
+
+          pt_source_scale.push_back(1.0);
+          pt_source_function.push_back(pt_source_strength[i]);
         }
     }
+
+// Sources listed in a file. They all share the same function, so that
+// their strengths are evaluated together.
+  const string pt_source_file = this->get("Point source file");
+  if (pt_source_file != "")
+    {
+      this->enter_subsection("Shared strength of point sources");
+      pt_source_shared_strength.parse_parameters(*this);
+      this->leave_subsection();
+
+      Function<dim> *shared_strength = &pt_source_shared_strength;
+      if (this->get("Strength of sources in file") == "Time series")
+        {
+          pt_source_time_series.read(this->get("Strength time series file"));
+          shared_strength = &pt_source_time_series;
+        }
+
+      const unsigned int n_listed = pt_source_location.size();
+      read_point_sources(pt_source_file, pt_source_location, pt_source_scale);
+      pt_source_function.resize(pt_source_location.size(), shared_strength);
+
+      n_pt_source = pt_source_location.size();
+      cout<<"No. of pts read from "<<pt_source_file<<" ="
+          <<n_pt_source - n_listed<<endl;
+    }
   this->leave_subsection();
 
   stokes_flow_like = this->get_bool("Time-dependent Stokes flow");
@@ -449,6 +749,18 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   //:
   this->leave_subsection();
 
+  this->enter_subsection("Probes");
+  fluid_probe_points = parse_point_list<dim>(this->get("Fluid probe points"));
+  solid_probe_points = parse_point_list<dim>(this->get("Solid probe points"));
+  this->leave_subsection();
+
+  this->enter_subsection("Adaptive fluid refinement");
+  adaptive_cycles_f = this->get_integer ("Number of cycles");
+  buffer_layers_f = this->get_integer ("Buffer layers");
+  kelly_fraction_f = this->get_double ("Kelly fraction");
+  remesh_interval_f = this->get_integer ("Remeshing interval (time steps)");
+  this->leave_subsection();
+
   fsi_bm = this->get_bool ("Turek-Hron FSI Benchmark test");
 
   cfd_test = this->get_bool("Turek-Hron CFD Benchmark test");
@@ -457,6 +769,9 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   use_dbc_solid = this->get_bool("Turek-Hron test-- Impose DBC for solid");
 
   only_NS = this->get_bool("Solve only NS component");
+  AssertThrow (!(only_NS && (jacobian_free || finite_difference_operator)),
+               ExcMessage ("Finite-difference Jacobians need the full system: "
+                           "they cannot be used when solving only the NS component."));
 
   static Functions::ZeroFunction<dim> zero_solid (dim);
 
@@ -489,8 +804,24 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
   save_for_restart = this->get_bool ("Save data for a possible restart");
   this_is_a_restart = this->get_bool ("This is a restart");
   file_info_for_restart = this->get("File prefix used for files needed for restart");
+  checkpoint_sparsity = this->get_bool ("Save sparsity pattern for restart");
+  checkpoint_step_interval = this->get_integer ("Checkpoint interval (time steps)");
+  checkpoint_minutes = this->get_double ("Checkpoint interval (minutes)");
+  n_checkpoints_kept = this->get_integer ("Number of checkpoints to keep");
+  background_checkpoints = this->get_bool ("Write checkpoints in the background");
+  restart_step = this->get_integer ("Restart from step");
+  restart_frames_name = this->get ("Base name of restart frames");
+  if (restart_frames_name.empty())
+    restart_frames_name = output_name;
   this->leave_subsection();
 
+// The frames only hold the solution, on a control volume that the
+// remeshing may have changed since the start of the run that wrote them.
+  AssertThrow (!(this_is_a_restart && (restart_step >= 0) && (remesh_interval_f > 0)),
+               ExcMessage ("A remeshed control volume is only saved in the "
+                           "checkpoints: \"Restart from step\" cannot be used "
+                           "with a positive \"Remeshing interval (time steps)\"."));
+
 
 // The following lines help keeping track of what prm file goes
 
@@ -506,7 +837,7 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
     this->print_parameters(paramfile, this->ShortText);
   }
 
-  if (n_pt_source) pt_source_strength[0]->set_time(0.);
+  if (pt_source_strength.size()) pt_source_strength[0]->set_time(0.);
   std::cout << "\n==============================" << std::endl;
   std::cout << "Parameters\n"
             << "==========\n"
@@ -537,7 +868,7 @@ IFEMParameters<dim>::IFEMParameters(int argc, char **argv) :
 template <int dim>
 IFEMParameters<dim>::~IFEMParameters()
 {
-  for (unsigned int i = 0; i < n_pt_source; ++i)
+  for (unsigned int i = 0; i < pt_source_strength.size(); ++i)
     delete pt_source_strength[i];
 }
 
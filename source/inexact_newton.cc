@@ -0,0 +1,106 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "inexact_newton.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+ForcingTerm::ForcingTerm ()
+  :
+  n_linear_solves (0),
+  n_linear_iterations (0),
+  n_total_linear_solves (0),
+  n_total_linear_iterations (0),
+  type (eisenstat_walker),
+  eta_0 (0.1),
+  eta_max (0.9),
+  newton_tolerance (0.0),
+  previous_norm (-1.0),
+  previous_eta (0.1)
+{}
+
+
+void
+ForcingTerm::initialize (const Type forcing_type,
+                         const double eta_initial,
+                         const double eta_maximum,
+                         const double tolerance)
+{
+  type = forcing_type;
+  eta_0 = eta_initial;
+  eta_max = eta_maximum;
+  newton_tolerance = tolerance;
+
+  n_total_linear_solves = 0;
+  n_total_linear_iterations = 0;
+}
+
+
+void
+ForcingTerm::begin_step ()
+{
+  n_linear_solves = 0;
+  n_linear_iterations = 0;
+  previous_norm = -1.0;
+  previous_eta = eta_0;
+}
+
+
+double
+ForcingTerm::value (const double res_norm)
+{
+  double eta = eta_0;
+
+  if ((type == eisenstat_walker) && (previous_norm > 0))
+    {
+      const double gamma = 0.9;
+      const double alpha = 2.0;
+
+      const double ratio = res_norm/previous_norm;
+      eta = gamma * std::pow (ratio, alpha);
+
+// Safeguard against a sudden decrease of the forcing term, which
+// would cause over-solving when the residual happens to drop by a
+// large factor in a single iteration.
+      const double eta_previous = gamma * std::pow (previous_eta, alpha);
+      if (eta_previous > 0.1)
+        eta = std::max (eta, eta_previous);
+
+      eta = std::min (eta, eta_max);
+    }
+
+// There is no point in solving more accurately than needed to reach
+// the tolerance of the Newton iteration.
+  if (res_norm > 0)
+    eta = std::max (eta, 0.5*newton_tolerance/res_norm);
+  eta = std::min (eta, eta_max);
+
+  previous_norm = res_norm;
+  previous_eta = eta;
+
+  return eta;
+}
+
+
+void
+ForcingTerm::linear_solve_done (const unsigned int n_iterations)
+{
+  ++n_linear_solves;
+  ++n_total_linear_solves;
+  n_linear_iterations += n_iterations;
+  n_total_linear_iterations += n_iterations;
+}
@@ -0,0 +1,39 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "jacobian_free.h"
+
+
+void
+BlockDiagonalPreconditioner::initialize (const DirectSolver &fluid,
+                                         const DirectSolver &solid,
+                                         const double factor)
+{
+  fluid_inverse = &fluid;
+  solid_inverse = &solid;
+  solid_factor = factor;
+}
+
+
+void
+BlockDiagonalPreconditioner::vmult (BlockVector<double> &dst,
+                                    const BlockVector<double> &src) const
+{
+  Assert (fluid_inverse != 0, ExcNotInitialized());
+
+  fluid_inverse->vmult (dst.block(0), src.block(0));
+  solid_inverse->vmult (dst.block(1), src.block(1));
+  dst.block(1) *= solid_factor;
+}
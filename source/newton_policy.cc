@@ -0,0 +1,183 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "newton_policy.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+NewtonPolicy::NewtonPolicy ()
+  :
+  n_iterations (0),
+  n_refreshes (0),
+  n_reuses (0),
+  n_total_iterations (0),
+  n_total_refreshes (0),
+  n_total_reuses (0),
+  contraction_ratio (0.0),
+  type (legacy),
+  absolute_tolerance (1e-10),
+  relative_tolerance (0.0),
+  contraction_threshold (0.5),
+  max_iterations (40),
+  refresh_continuously (false),
+  refresh_at_step_beginning (false),
+  refresh (true),
+  has_jacobian (false),
+  jacobian_is_current (false),
+  first_norm (0.0),
+  previous_norm (0.0),
+  cycle_iterations (0),
+  n_cycles (0)
+{}
+
+
+void
+NewtonPolicy::initialize (const Type policy_type,
+                          const double abs_tol,
+                          const double rel_tol,
+                          const double threshold,
+                          const unsigned int max_iter,
+                          const bool continuously,
+                          const bool at_step_beginning)
+{
+  type = policy_type;
+  absolute_tolerance = abs_tol;
+  relative_tolerance = rel_tol;
+  contraction_threshold = threshold;
+  max_iterations = max_iter;
+  refresh_continuously = continuously;
+  refresh_at_step_beginning = at_step_beginning;
+
+  refresh = true;
+  has_jacobian = false;
+  jacobian_is_current = false;
+}
+
+
+// The first step always starts with a new Jacobian. Afterwards, the
+// Jacobian of the previous step is kept unless the parameter file
+// requires otherwise.
+
+void
+NewtonPolicy::begin_step ()
+{
+  n_iterations = 0;
+  n_refreshes = 0;
+  n_reuses = 0;
+  contraction_ratio = 0.0;
+
+  first_norm = -1.0;
+  previous_norm = -1.0;
+
+  cycle_iterations = 0;
+  n_cycles = 0;
+
+  jacobian_is_current = false;
+  refresh = (!has_jacobian
+             ||
+             refresh_continuously
+             ||
+             refresh_at_step_beginning);
+}
+
+
+void
+NewtonPolicy::jacobian_refreshed ()
+{
+  has_jacobian = true;
+  jacobian_is_current = true;
+  refresh = refresh_continuously;
+  ++n_refreshes;
+  ++n_total_refreshes;
+}
+
+
+void
+NewtonPolicy::jacobian_reused ()
+{
+  ++n_reuses;
+  ++n_total_reuses;
+}
+
+
+bool
+NewtonPolicy::converged (const double res_norm)
+{
+  if (first_norm < 0)
+    first_norm = res_norm;
+
+  if (res_norm < std::max (absolute_tolerance,
+                           relative_tolerance*first_norm))
+    return true;
+
+  if (previous_norm > 0)
+    {
+      contraction_ratio = res_norm/previous_norm;
+
+// A factorization that is not at least this effective is not worth
+// keeping, unless it was just computed.
+      if ((type == contraction)
+          &&
+          (contraction_ratio > contraction_threshold)
+          &&
+          !jacobian_is_current)
+        refresh = true;
+    }
+  previous_norm = res_norm;
+
+  return false;
+}
+
+
+void
+NewtonPolicy::update_computed (const double res_norm)
+{
+  ++n_iterations;
+  ++n_total_iterations;
+  jacobian_is_current = false;
+
+  if (type == contraction)
+    {
+      AssertThrow (n_iterations <= max_iterations,
+                   ExcMessage ("No convergence in nonlinear solver."));
+      return;
+    }
+
+// If the update was computed from a very poor residual, the Jacobian
+// is updated before computing the next one. If convergence is not
+// achieved in 10 iterations, the Jacobian is updated and we try again.
+// The maximum number of 10-iteration cycles is set (arbitrarily) to
+// three.
+  if (res_norm > 1e-2)
+    refresh = true;
+
+  ++cycle_iterations;
+  if (cycle_iterations == 10)
+    {
+      refresh = true;
+      cycle_iterations = 0;
+      ++n_cycles;
+      printf (
+        "   %-16.3e (not converged in 10 iterations. Step %d)\n\n",
+        res_norm,
+        n_cycles
+      );
+    }
+
+  AssertThrow (n_cycles <= 3,
+               ExcMessage ("No convergence in nonlinear solver."));
+}
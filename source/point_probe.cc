@@ -0,0 +1,127 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "point_probe.h"
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/fe/fe.h>
+
+#include <sstream>
+
+
+template <int dim>
+PointProbe<dim>::PointProbe ()
+  :
+  n_components (0)
+{}
+
+
+template <int dim>
+void
+PointProbe<dim>::initialize (const Mapping<dim> &mapping,
+                             const DoFHandler<dim> &dh,
+                             const Point<dim> &p,
+                             const CartesianGridLocator<dim> *grid)
+{
+  point = p;
+
+  ostringstream message;
+  message << "The probe point (" << p << ") is outside of the mesh.";
+
+  if (grid != 0 && grid->is_cartesian())
+    {
+      const bool found = grid->locate (p, cell, unit_point);
+      AssertThrow (found, ExcMessage (message.str()));
+    }
+  else
+    {
+      std::pair<typename DoFHandler<dim>::active_cell_iterator, Point<dim> >
+      cell_and_point;
+      try
+        {
+          cell_and_point = GridTools::find_active_cell_around_point (mapping, dh, p);
+        }
+      catch (...)
+        {
+          AssertThrow (false, ExcMessage (message.str()));
+        }
+
+      cell = cell_and_point.first;
+      unit_point = GeometryInfo<dim>::project_to_unit_cell (cell_and_point.second);
+    }
+
+  const FiniteElement<dim> &fe = dh.get_fe();
+  n_components = fe.n_components();
+
+  dofs.resize (fe.dofs_per_cell);
+  components.resize (fe.dofs_per_cell);
+  weights.resize (fe.dofs_per_cell);
+
+  cell->get_dof_indices (dofs);
+  for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+    {
+      components[i] = fe.system_to_component_index(i).first;
+      weights[i] = fe.shape_value (i, unit_point);
+    }
+}
+
+
+template <int dim>
+void
+PointProbe<dim>::value (const Vector<double> &x,
+                        Vector<double> &values) const
+{
+  Assert (is_initialized(), ExcNotInitialized());
+  Assert (values.size() == n_components,
+          ExcDimensionMismatch (values.size(), n_components));
+
+  values = 0;
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    values(components[i]) += weights[i] * x(dofs[i]);
+}
+
+
+template <int dim>
+double
+PointProbe<dim>::value (const Vector<double> &x,
+                        const unsigned int component) const
+{
+  Assert (is_initialized(), ExcNotInitialized());
+
+  double v = 0;
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    if (components[i] == component)
+      v += weights[i] * x(dofs[i]);
+  return v;
+}
+
+
+template <int dim>
+vector< pair<unsigned int, double> >
+PointProbe<dim>::component_weights (const unsigned int component) const
+{
+  Assert (is_initialized(), ExcNotInitialized());
+
+  vector< pair<unsigned int, double> > w;
+  for (unsigned int i=0; i<dofs.size(); ++i)
+    if (components[i] == component)
+      w.push_back (std::make_pair (dofs[i], weights[i]));
+  return w;
+}
+
+
+template class PointProbe<2>;
+template class PointProbe<3>;
@@ -0,0 +1,320 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "point_source_set.h"
+#include "point_probe.h"
+
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+
+namespace
+{
+// Open a file for reading, or throw an exception naming it.
+  void open_input_file (const string &filename,
+                        ifstream &file)
+  {
+    file.open (filename.c_str());
+    AssertThrow (file, ExcMessage ("Could not open the file " + filename + "."));
+  }
+
+
+// Whether the line carries data, i.e., it is neither empty nor a comment.
+  bool is_data_line (const string &line)
+  {
+    const string::size_type first = line.find_first_not_of (" \t\r");
+    return (first != string::npos) && (line[first] != '#');
+  }
+}
+
+
+template <int dim>
+TimeSeriesFunction<dim>::TimeSeriesFunction ()
+  :
+  Function<dim> (1)
+{}
+
+
+template <int dim>
+void
+TimeSeriesFunction<dim>::read (const string &filename)
+{
+  times.clear ();
+  values.clear ();
+
+  ifstream file;
+  open_input_file (filename, file);
+
+  string line;
+  unsigned int line_no = 0;
+  while (getline (file, line))
+    {
+      ++line_no;
+      if (!is_data_line (line))
+        continue;
+
+      istringstream entries (line);
+      double t, v;
+      entries >> t >> v;
+      AssertThrow (entries,
+                   ExcMessage ("Line " + Utilities::int_to_string (line_no)
+                               + " of " + filename
+                               + " does not contain a time and a value."));
+      AssertThrow (times.empty() || (t > times.back()),
+                   ExcMessage ("The times in " + filename
+                               + " are not increasing at line "
+                               + Utilities::int_to_string (line_no) + "."));
+      times.push_back (t);
+      values.push_back (v);
+    }
+
+  AssertThrow (!times.empty(),
+               ExcMessage ("The file " + filename + " contains no data."));
+}
+
+
+template <int dim>
+double
+TimeSeriesFunction<dim>::current_value () const
+{
+  Assert (!times.empty(), ExcNotInitialized());
+
+  const double t = this->get_time();
+  if (t <= times.front())
+    return values.front();
+  if (t >= times.back())
+    return values.back();
+
+  const unsigned int i = upper_bound (times.begin(), times.end(), t)
+                         - times.begin();
+  const double theta = (t - times[i-1])/(times[i] - times[i-1]);
+  return (1.0 - theta)*values[i-1] + theta*values[i];
+}
+
+
+template <int dim>
+double
+TimeSeriesFunction<dim>::value (const Point<dim> &,
+                                const unsigned int component) const
+{
+  Assert (component == 0, ExcIndexRange (component, 0, 1));
+  return current_value ();
+}
+
+
+template <int dim>
+void
+TimeSeriesFunction<dim>::value_list (const vector< Point<dim> > &points,
+                                     vector<double> &values_at_points,
+                                     const unsigned int component) const
+{
+  Assert (component == 0, ExcIndexRange (component, 0, 1));
+  Assert (values_at_points.size() == points.size(),
+          ExcDimensionMismatch (values_at_points.size(), points.size()));
+
+  fill (values_at_points.begin(), values_at_points.end(), current_value ());
+}
+
+
+template <int dim>
+void
+read_point_sources (const string &filename,
+                    vector< Point<dim> > &locations,
+                    vector<double> &scales)
+{
+  ifstream file;
+  open_input_file (filename, file);
+
+  string line;
+  unsigned int line_no = 0;
+  while (getline (file, line))
+    {
+      ++line_no;
+      if (!is_data_line (line))
+        continue;
+
+      istringstream entries (line);
+      Point<dim> p;
+      for (unsigned int d=0; d<dim; ++d)
+        entries >> p[d];
+      AssertThrow (entries,
+                   ExcMessage ("Line " + Utilities::int_to_string (line_no)
+                               + " of " + filename + " does not contain "
+                               + Utilities::int_to_string (dim)
+                               + " coordinates."));
+
+// The factor is one only if the line ends after the coordinates.
+      double scale = 1.0;
+      string factor, rest;
+      if (entries >> factor)
+        {
+          istringstream value (factor);
+          AssertThrow ((value >> scale) && !(value >> rest) && !(entries >> rest),
+                       ExcMessage ("Line " + Utilities::int_to_string (line_no)
+                                   + " of " + filename + " does not end with "
+                                   + Utilities::int_to_string (dim)
+                                   + " coordinates and, optionally, a factor."));
+        }
+
+      locations.push_back (p);
+      scales.push_back (scale);
+    }
+}
+
+
+template <int dim>
+PointSourceSet<dim>::PointSourceSet ()
+  :
+  strength_time (0.0),
+  has_strengths (false)
+{}
+
+
+template <int dim>
+void
+PointSourceSet<dim>::clear ()
+{
+  locations.clear ();
+  scales.clear ();
+  functions.clear ();
+  function_sources.clear ();
+  function_locations.clear ();
+  function_values.clear ();
+  strengths.clear ();
+  has_strengths = false;
+
+  entry_sources.clear ();
+  entry_dofs.clear ();
+  entry_weights.clear ();
+  touched_dofs.clear ();
+}
+
+
+template <int dim>
+void
+PointSourceSet<dim>::add (const Point<dim> &location,
+                          Function<dim> &strength,
+                          const double scale)
+{
+  const unsigned int source = locations.size();
+  locations.push_back (location);
+  scales.push_back (scale);
+  strengths.push_back (0.0);
+  has_strengths = false;
+
+// Sources sharing a function are grouped, so that the function is
+// evaluated with a single call for all of them.
+  const unsigned int f = find (functions.begin(), functions.end(), &strength)
+                         - functions.begin();
+  if (f == functions.size())
+    {
+      functions.push_back (&strength);
+      function_sources.push_back (vector<unsigned int>());
+      function_locations.push_back (vector< Point<dim> >());
+    }
+  function_sources[f].push_back (source);
+  function_locations[f].push_back (location);
+}
+
+
+template <int dim>
+void
+PointSourceSet<dim>::initialize (const Mapping<dim> &mapping,
+                                 const DoFHandler<dim> &dh,
+                                 const unsigned int component)
+{
+  entry_sources.clear ();
+  entry_dofs.clear ();
+  entry_weights.clear ();
+  touched_dofs.clear ();
+
+  for (unsigned int i=0; i<locations.size(); ++i)
+    {
+      PointProbe<dim> probe;
+      probe.initialize (mapping, dh, locations[i]);
+
+      const vector< pair<unsigned int, double> > weights
+        = probe.component_weights (component);
+      for (unsigned int j=0; j<weights.size(); ++j)
+        {
+          entry_sources.push_back (i);
+          entry_dofs.push_back (weights[j].first);
+          entry_weights.push_back (weights[j].second);
+          touched_dofs.push_back (weights[j].first);
+        }
+    }
+
+  sort (touched_dofs.begin(), touched_dofs.end());
+  touched_dofs.erase (unique (touched_dofs.begin(), touched_dofs.end()),
+                      touched_dofs.end());
+}
+
+
+template <int dim>
+const vector<double> &
+PointSourceSet<dim>::get_strengths (const double t)
+{
+  if (has_strengths && (t == strength_time))
+    return strengths;
+
+  for (unsigned int f=0; f<functions.size(); ++f)
+    {
+      const vector<unsigned int> &sources = function_sources[f];
+      function_values.resize (sources.size());
+
+      functions[f]->set_time (t);
+      functions[f]->value_list (function_locations[f], function_values);
+
+      for (unsigned int i=0; i<sources.size(); ++i)
+        strengths[sources[i]] = scales[sources[i]]*function_values[i];
+    }
+
+  strength_time = t;
+  has_strengths = true;
+  return strengths;
+}
+
+
+template <int dim>
+void
+PointSourceSet<dim>::assemble (const double t,
+                               const double factor,
+                               Vector<double> &v)
+{
+  const vector<double> &s = get_strengths (t);
+
+  for (unsigned int i=0; i<touched_dofs.size(); ++i)
+    v(touched_dofs[i]) = 0.0;
+
+  for (unsigned int k=0; k<entry_dofs.size(); ++k)
+    v(entry_dofs[k]) += factor*s[entry_sources[k]]*entry_weights[k];
+}
+
+
+template class TimeSeriesFunction<2>;
+template class TimeSeriesFunction<3>;
+
+template class PointSourceSet<2>;
+template class PointSourceSet<3>;
+
+template void read_point_sources (const string &,
+                                  vector< Point<2> > &,
+                                  vector<double> &);
+template void read_point_sources (const string &,
+                                  vector< Point<3> > &,
+                                  vector<double> &);
@@ -124,29 +124,51 @@ template <int dim>
 void
 PostProcessor<dim>::create_triangulation_and_dofs ()
 {
-  GridIn<dim> grid_in_f;
-  grid_in_f.attach_triangulation (tria_f);
-
+// The refined triangulations and the numbering of the dofs are read
+// from the setup cache, if it is enabled and holds them. The manifold
+// objects are attached in any case.
   {
-    ifstream file (par.fluid_mesh.c_str());
-    Assert (file, ExcFileNotOpen (par.fluid_mesh.c_str()));
+    vector<string> mesh_files (1, par.fluid_mesh);
+    mesh_files.push_back (par.solid_mesh);
+    setup_cache.initialize (
+      par.setup_cache_directory,
+      "post_processor ref_f=" + Utilities::int_to_string (par.ref_f)
+      + " ref_s=" + Utilities::int_to_string (par.ref_s)
+      + " fe_f=" + fe_f.get_name()
+      + " fe_s=" + fe_s.get_name()
+      + " renumbering=" + par.dof_renumbering
+      + " fsi_bm=" + (par.fsi_bm ? "true" : "false")
+      + local_refinement_description (par),
+      mesh_files);
+  }
 
+  const bool setup_from_cache = setup_cache.load (tria_f, tria_s);
+  if (!setup_from_cache)
+    {
+      GridIn<dim> grid_in_f;
+      grid_in_f.attach_triangulation (tria_f);
 
-    // A grid in mesh format is expected.
-    grid_in_f.read_msh (file);
-  }
-  GridTools::copy_boundary_to_manifold_id(tria_f);
-  {
-    GridIn<dim, dim> grid_in_s;
-    grid_in_s.attach_triangulation (tria_s);
+      {
+        ifstream file (par.fluid_mesh.c_str());
+        Assert (file, ExcFileNotOpen (par.fluid_mesh.c_str()));
 
-    ifstream file (par.solid_mesh.c_str());
-    Assert (file, ExcFileNotOpen (par.solid_mesh.c_str()));
 
-    // A grid in ucd format is expected.
-    grid_in_s.read_msh (file);
-  }
-  GridTools::copy_boundary_to_manifold_id(tria_f);
+        // A grid in mesh format is expected.
+        grid_in_f.read_msh (file);
+      }
+      GridTools::copy_boundary_to_manifold_id(tria_f);
+      {
+        GridIn<dim, dim> grid_in_s;
+        grid_in_s.attach_triangulation (tria_s);
+
+        ifstream file (par.solid_mesh.c_str());
+        Assert (file, ExcFileNotOpen (par.solid_mesh.c_str()));
+
+        // A grid in ucd format is expected.
+        grid_in_s.read_msh (file);
+      }
+      GridTools::copy_boundary_to_manifold_id(tria_f);
+    }
 
   if (par.fsi_bm && dim == 2)
     {
@@ -163,7 +185,8 @@ PostProcessor<dim>::create_triangulation_and_dofs ()
       << "Number of fluid refines = "
       << par.ref_f
       << endl;
-  tria_f.refine_global (par.ref_f);
+  if (!setup_from_cache)
+    tria_f.refine_global (par.ref_f);
   cout
       << "Number of active fluid cells: "
       << tria_f.n_active_cells ()
@@ -180,7 +203,19 @@ PostProcessor<dim>::create_triangulation_and_dofs ()
       << "Number of solid refines = "
       << par.ref_s
       << endl;
-  tria_s.refine_global (par.ref_s);
+  if (!setup_from_cache)
+    tria_s.refine_global (par.ref_s);
+
+// The local refinement of the control volume needs the refined
+// immersed domain. It must be the same as in the simulation.
+  if (!setup_from_cache && par.adaptive_cycles_f > 0)
+    {
+      refine_around_immersed_domain (tria_f, tria_s, fe_f, quad_s, par);
+      cout
+          << "Number of active fluid cells after local refinement: "
+          << tria_f.n_active_cells ()
+          << endl;
+    }
   cout
       << "Number of active solid cells: "
       << tria_s.n_active_cells ()
@@ -200,17 +235,29 @@ PostProcessor<dim>::create_triangulation_and_dofs ()
 
 // Distribution of the degrees of freedom. Both for the solid
 // and fluid domains, the dofs are renumbered first globally
-// and then by component.
+// and then by component. With a setup restored from the cache, the
+// numbering is the one saved in it; otherwise, it is saved there.
   dh_f.distribute_dofs (fe_f);
-  DoFRenumbering::boost::Cuthill_McKee (dh_f);
+  dh_s.distribute_dofs (fe_s);
 
+  vector<unsigned int> block_component (dim+1,0);
+  block_component[dim] = 1;
+
+  if (setup_from_cache)
+    setup_cache.renumber_dofs (dh_f, dh_s);
+  else
+    {
+      renumber_dofs (dh_f, par.dof_renumbering);
 
 // Consistently with the fact that the various components of
 // the system are stored in a block matrix, now renumber
 // velocity and pressure component wise.
-  vector<unsigned int> block_component (dim+1,0);
-  block_component[dim] = 1;
-  DoFRenumbering::component_wise (dh_f, block_component);
+      DoFRenumbering::component_wise (dh_f, block_component);
+
+      renumber_dofs (dh_s, par.dof_renumbering);
+
+      setup_cache.save (tria_f, tria_s, dh_f, dh_s);
+    }
 
   vector<unsigned int> dofs_per_block (2);
   DoFTools::count_dofs_per_block (dh_f, dofs_per_block, block_component);
@@ -223,15 +270,14 @@ PostProcessor<dim>::create_triangulation_and_dofs ()
   n_dofs_up = dh_f.n_dofs ();
 
 
-// Simply distribute dofs on the solid displacement.
-  dh_s.distribute_dofs (fe_s);
-  DoFRenumbering::boost::Cuthill_McKee (dh_s);
-
-
 // Determine the total number of dofs.
   n_dofs_W = dh_s.n_dofs ();
   n_total_dofs = n_dofs_up+n_dofs_W;
 
+// Boundary faces of the control volume, used at every output step.
+  fluid_geometry.initialize (dh_f);
+  solid_support_points.initialize (StaticMappingQ1<dim>::mapping, dh_s);
+
   cout
       << "dim (V_h) = "
       << n_dofs_u
@@ -341,20 +387,16 @@ PostProcessor<dim>::run ()
 // End of <code>run()</code>.
 
 
-template<int dim, int spacedim>
-std::vector<unsigned int> get_point_dofs(const DoFHandler<dim,spacedim> &dh,
-                                         const Point<spacedim> &p,
-                                         const Mapping<dim,spacedim> &mapping
-                                         =StaticMappingQ1<dim,spacedim>::mapping,
+// The dofs whose support points coincide with <code>p</code>, found
+// through the index of the support points built once per DoFHandler.
+template<int dim>
+std::vector<unsigned int> get_point_dofs(const SupportPointIndex<dim> &index,
+                                         const Point<dim> &p,
                                          const double tol=1e-10)
 {
-  std::vector< Point<spacedim> > support_points(dh.n_dofs());
-  DoFTools::map_dofs_to_support_points(mapping, dh, support_points);
-  std::vector<unsigned int> dofs;
   const double rel_tol=std::max(tol, tol*p.norm());
-  for (unsigned int i=0; i<support_points.size(); ++i)
-    if (support_points[i].distance(p) < rel_tol)
-      dofs.push_back(i);
+  const std::vector<unsigned int> dofs
+    = index.within_radius(std::vector<Point<dim> >(1, p), rel_tol)[0];
   if (dofs.size())
     {
       cout << "Found " << dofs.size() << " point dofs: ";
@@ -386,9 +428,6 @@ PostProcessor<dim>::post_process(const double t, const unsigned int step, const
 
   {
 // Assemble in and out flux.
-    typename DoFHandler<dim,dim>::active_cell_iterator
-    cell = dh_f.begin_active(),
-    endc = dh_f.end();
     QGauss<dim-1> face_quad(par.degree+2);
     FEFaceValues<dim,dim> fe_v (fe_f,
                                 face_quad,
@@ -399,21 +438,22 @@ PostProcessor<dim>::post_process(const double t, const unsigned int step, const
     vector<Vector<double> > local_vp(face_quad.size(),
                                      Vector<double>(dim+1));
 
+    const vector<typename GeometryCache<dim>::CellFace> &faces
+      = fluid_geometry.boundary_faces;
+
     double flux=0;
-    for (; cell != endc; ++cell)
-      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
-        if (cell->face(f)->at_boundary())
+    for (unsigned int b=0; b<faces.size(); ++b)
+      {
+        fe_v.reinit(faces[b].first, faces[b].second);
+        fe_v.get_function_values(current_xi.block(0), local_vp);
+        const vector<Tensor<1,dim> > &normals = fe_v.get_normal_vectors();
+        for (unsigned int q=0; q<face_quad.size(); ++q)
           {
-            fe_v.reinit(cell, f);
-            fe_v.get_function_values(current_xi.block(0), local_vp);
-            const vector<Tensor<1,dim> > &normals = fe_v.get_normal_vectors();
-            for (unsigned int q=0; q<face_quad.size(); ++q)
-              {
-                Point<dim> vq;
-                for (unsigned int d=0; d<dim; ++d) vq[d] = local_vp[q](d);
-                flux += (vq*normals[q])*fe_v.JxW(q);
-              }
+            Point<dim> vq;
+            for (unsigned int d=0; d<dim; ++d) vq[d] = local_vp[q](d);
+            flux += (vq*normals[q])*fe_v.JxW(q);
           }
+      }
     global_info_file
         << flux
         << " ";
@@ -475,24 +515,22 @@ PostProcessor<dim>::post_process(const double t, const unsigned int step, const
 
     Point<dim> drag_lift;
 
-    static vector<unsigned int> A_dofs = get_point_dofs(dh_s, point_A);
-    if (A_dofs.size() == 0)
+    if (!probe_B.is_initialized())
       {
-        VectorTools::point_value(dh_s,
-                                 current_xi.block(1),
-                                 point_A,
-                                 disp_A);
+        probe_A.initialize(StaticMappingQ1<dim>::mapping, dh_s, point_A);
+        probe_B.initialize(StaticMappingQ1<dim>::mapping, dh_f, point_B);
       }
+
+    static vector<unsigned int> A_dofs = get_point_dofs(solid_support_points, point_A);
+    if (A_dofs.size() == 0)
+      probe_A.value(current_xi.block(1), disp_A);
     else
       {
         for (int d=0; d<dim; ++d)
           disp_A(d) = current_xi.block(1)(A_dofs[d]);
       }
 
-    VectorTools::point_value(dh_f,
-                             current_xi.block(0),
-                             point_B,
-                             sol_B);
+    probe_B.value(current_xi.block(0), sol_B);
 
     //-------------------- Loop over FLUID CELLS-----------------//
     //Calculating the drag and lift values corresponding to the free surface of the cylinder
@@ -566,49 +604,47 @@ PostProcessor<dim>::post_process(const double t, const unsigned int step, const
                     * fe_f_v.JxW(q);
               }
           }
+      }//loop over cells
 
-        //: Surface integration over all the boundaries of the control volume
-        // EXCEPT those comprising the cylinder + the flag
-        for (unsigned int face=0; face < GeometryInfo<dim>::faces_per_cell; ++face)
-          {
-            if (cell->face(face)->at_boundary() &&
-                face_not_on_cylinder<dim>(cell->face(face)))
-              {
-                fe_f_face_v.reinit (cell, face);
+    //: Surface integration over all the boundaries of the control volume
+    // EXCEPT those comprising the cylinder + the flag
+    const vector<typename GeometryCache<dim>::CellFace> &faces
+      = fluid_geometry.boundary_faces;
+    for (unsigned int b=0; b<faces.size(); ++b)
+      {
+        const typename DoFHandler<dim,dim>::active_cell_iterator &cell = faces[b].first;
+        const unsigned int face = faces[b].second;
 
-                fe_f_face_v.get_function_values (current_xi.block(0), sol_f_face);
-                fe_f_face_v.get_function_gradients (current_xi.block(0), sol_grad_f_face);
+        if (face_not_on_cylinder<dim>(cell->face(face)))
+          {
+            fe_f_face_v.reinit (cell, face);
 
-                for (unsigned int q = 0; q < n_qpf_face; ++q) //loop over quadrature pts
-                  {
-                    for (unsigned int i = 0; i < dim; ++i) //loop over dim
-                      for (unsigned int j = 0; j < dim; ++j) //loop over dim
-                        drag_lift[i] += //(T_f - p I)*(n da)
-                          (par.eta_f
-                           *(sol_grad_f_face[q][i][j]
-                             + sol_grad_f_face[q][j][i])
-                           - (i == j ? sol_f_face[q](dim) : 0.0)
-                          )
-                          *(fe_f_face_v.normal_vector(q)[j])
-                          *fe_f_face_v.JxW(q);
-                  }//loop over q
-              }//if cond.
-          }//loop over faces
+            fe_f_face_v.get_function_values (current_xi.block(0), sol_f_face);
+            fe_f_face_v.get_function_gradients (current_xi.block(0), sol_grad_f_face);
 
-      }//loop over cells
+            for (unsigned int q = 0; q < n_qpf_face; ++q) //loop over quadrature pts
+              {
+                for (unsigned int i = 0; i < dim; ++i) //loop over dim
+                  for (unsigned int j = 0; j < dim; ++j) //loop over dim
+                    drag_lift[i] += //(T_f - p I)*(n da)
+                      (par.eta_f
+                       *(sol_grad_f_face[q][i][j]
+                         + sol_grad_f_face[q][j][i])
+                       - (i == j ? sol_f_face[q](dim) : 0.0)
+                      )
+                      *(fe_f_face_v.normal_vector(q)[j])
+                      *fe_f_face_v.JxW(q);
+              }//loop over q
+          }//if cond.
+      }//loop over faces
 
     ///-------------------- Loop over FLUID CELLS (end)-----------------//
     {
-      //We find the solid cell in which point A resides and then
-      //associate a quadrature point with point A. Note a quadrature point can only
+      //The solid cell in which point A resides is known from its probe, and
+      //we associate a quadrature point with point A. Note a quadrature point can only
       //lie in a unit cell.
-      const pair<typename DoFHandler<dim, dim>::active_cell_iterator, Point<dim> > cell_and_point
-        = GridTools::find_active_cell_around_point (StaticMappingQ1<dim, dim>::mapping,
-                                                    dh_s,
-                                                    point_A);
-
-      typename DoFHandler<dim, dim>::active_cell_iterator cell_having_point_A = cell_and_point.first;
-      Point<dim> unit_cell_point_A = GeometryInfo<dim>::project_to_unit_cell(cell_and_point.second);
+      const typename DoFHandler<dim, dim>::active_cell_iterator cell_having_point_A = probe_A.cell;
+      const Point<dim> unit_cell_point_A = probe_A.unit_point;
 
 
       Quadrature<dim> quad_point_A (unit_cell_point_A);
@@ -736,35 +772,33 @@ PostProcessor<dim>::post_process(const double t, const unsigned int step, const
 
             }
 
-          //--------------------------------------------------------------//
-          //-------        CALCULATION OF PRESSURE AT POINT A ------------//
-          //--------------------------------------------------------------//
-          //Calculate the pressure at point A & the viscous stress (if any)
-          if (cell_s == cell_having_point_A)
-            {
-              fe_s_v_mapped_point_A.reinit(cell_s);
+        }//End loop over solid cells
 
-              up_field.compute_point_locations (fe_s_v_mapped_point_A.get_quadrature_points(),
-                                                fluid_cells,
-                                                fluid_qpoints,
-                                                fluid_maps);
+      //--------------------------------------------------------------//
+      //-------        CALCULATION OF PRESSURE AT POINT A ------------//
+      //--------------------------------------------------------------//
+      //Calculate the pressure at point A & the viscous stress (if any)
+      {
+        fe_s_v_mapped_point_A.reinit(cell_having_point_A);
 
-              Assert(fluid_cells.size() == 1, ExcMessage("Mapped point A found in multiple fluid cells!"));
-              Quadrature<dim> quad_bg (fluid_qpoints[0]);
+        up_field.compute_point_locations (fe_s_v_mapped_point_A.get_quadrature_points(),
+                                          fluid_cells,
+                                          fluid_qpoints,
+                                          fluid_maps);
 
-              FEValues<dim> fe_v_bg (fe_f, quad_bg,
-                                     update_values | update_gradients);
-              fe_v_bg.reinit(fluid_cells[0]);
+        Assert(fluid_cells.size() == 1, ExcMessage("Mapped point A found in multiple fluid cells!"));
+        Quadrature<dim> quad_bg (fluid_qpoints[0]);
 
-              //Localize the solution for the obtained fluid cell...but before that, resize the vectors
-              sol_f.resize(1, Vector <double> (dim+1));
+        FEValues<dim> fe_v_bg (fe_f, quad_bg,
+                               update_values | update_gradients);
+        fe_v_bg.reinit(fluid_cells[0]);
 
-              fe_v_bg.get_function_values (current_xi.block(0), sol_f);
-              pressure_A = sol_f[0](dim);
+        //Localize the solution for the obtained fluid cell...but before that, resize the vectors
+        sol_f.resize(1, Vector <double> (dim+1));
 
-            }
-
-        }//End loop over solid cells
+        fe_v_bg.get_function_values (current_xi.block(0), sol_f);
+        pressure_A = sol_f[0](dim);
+      }
 
     }//For FSI test only
 
@@ -0,0 +1,252 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#include "setup_cache.h"
+#include "checkpoint.h"
+
+#include <deal.II/base/utilities.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+
+namespace
+{
+// Hexadecimal representation of a hash, used in the name of the file.
+  string to_hex (const uint64_t value)
+  {
+    ostringstream out;
+    out << hex << setw(16) << setfill('0') << value;
+    return out.str();
+  }
+}
+
+
+template <int dim>
+void
+final_dof_numbering (const DoFHandler<dim> &dh,
+                     vector<types::global_dof_index> &numbering)
+{
+  DoFHandler<dim> fresh (dh.get_triangulation());
+  fresh.distribute_dofs (dh.get_fe());
+
+  numbering.resize (dh.n_dofs());
+  vector<types::global_dof_index> fresh_dofs (dh.get_fe().dofs_per_cell);
+  vector<types::global_dof_index> dofs (dh.get_fe().dofs_per_cell);
+
+  typename DoFHandler<dim>::active_cell_iterator
+  fresh_cell = fresh.begin_active (),
+  cell = dh.begin_active (),
+  endc = dh.end ();
+  for (; cell != endc; ++cell, ++fresh_cell)
+    {
+      fresh_cell->get_dof_indices (fresh_dofs);
+      cell->get_dof_indices (dofs);
+      for (unsigned int i=0; i<dofs.size(); ++i)
+        numbering[fresh_dofs[i]] = dofs[i];
+    }
+}
+
+
+template <int dim>
+SetupCache<dim>::SetupCache ()
+  :
+  is_loaded (false),
+  with_sparsity (false)
+{}
+
+
+template <int dim>
+void
+SetupCache<dim>::initialize (const string &directory,
+                             const string &description,
+                             const vector<string> &files)
+{
+  filename.clear ();
+  cache_directory = directory;
+  is_loaded = false;
+  with_sparsity = false;
+
+  if (directory.empty())
+    return;
+
+// The content of the files enters the key through its checksum.
+  key = description + " dim=" + Utilities::int_to_string (dim);
+  for (unsigned int i=0; i<files.size(); ++i)
+    {
+      ifstream file (files[i].c_str(), ios::binary);
+      AssertThrow (file, ExcFileNotOpen (files[i].c_str()));
+      ostringstream content;
+      content << file.rdbuf();
+      const string data = content.str();
+      key += " " + files[i] + ":" + to_hex (fnv1a_checksum (data.data(), data.size()));
+    }
+
+  filename = (directory
+              + "/setup-"
+              + to_hex (fnv1a_checksum (key.data(), key.size()))
+              + ".bin");
+}
+
+
+template <int dim>
+bool
+SetupCache<dim>::load (Triangulation<dim> &tria_f,
+                       Triangulation<dim> &tria_s)
+{
+  if (!enabled() || !file_exists (filename))
+    return false;
+
+// A cache that cannot be read, or that belongs to another key with the
+// same hash, is ignored, and overwritten later.
+  try
+    {
+      istringstream data (read_checkpoint (filename));
+      boost::archive::binary_iarchive ia (data);
+
+      string stored_key;
+      ia >> stored_key;
+      if (stored_key != key)
+        return false;
+
+      ia >> tria_f >> tria_s;
+      ia >> numbering_f >> numbering_s;
+      ia >> with_sparsity;
+      if (with_sparsity)
+        ia >> sparsity_f >> sparsity_s;
+    }
+  catch (const std::exception &exc)
+    {
+      cerr
+          << " Ignoring the setup cache "
+          << filename
+          << ": "
+          << exc.what()
+          << endl;
+      tria_f.clear ();
+      tria_s.clear ();
+      with_sparsity = false;
+      return false;
+    }
+
+  is_loaded = true;
+  cout
+      << "Setup restored from "
+      << filename
+      << endl;
+  return true;
+}
+
+
+template <int dim>
+void
+SetupCache<dim>::renumber_dofs (DoFHandler<dim> &dh_f,
+                                DoFHandler<dim> &dh_s) const
+{
+  Assert (is_loaded, ExcMessage ("The setup was not restored from the cache."));
+  AssertThrow (numbering_f.size() == dh_f.n_dofs()
+               &&
+               numbering_s.size() == dh_s.n_dofs(),
+               ExcMessage ("The numbering of the dofs in the setup cache "
+                           + filename + " does not match the dofs."));
+
+  dh_f.renumber_dofs (numbering_f);
+  dh_s.renumber_dofs (numbering_s);
+}
+
+
+template <int dim>
+void
+SetupCache<dim>::clear_sparsity ()
+{
+  sparsity_f.reinit (0, 0, 0);
+  sparsity_s.reinit (0, 0, 0);
+}
+
+
+// Failing to write the cache is not an error: the computation goes on,
+// and the setup is computed again next time.
+
+template <int dim>
+void
+SetupCache<dim>::save (const Triangulation<dim> &tria_f,
+                       const Triangulation<dim> &tria_s,
+                       const DoFHandler<dim> &dh_f,
+                       const DoFHandler<dim> &dh_s,
+                       const SparsityPattern *fluid_pattern,
+                       const SparsityPattern *solid_pattern)
+{
+  if (!enabled())
+    return;
+
+  final_dof_numbering (dh_f, numbering_f);
+  final_dof_numbering (dh_s, numbering_s);
+  const bool save_sparsity = (fluid_pattern != 0 && solid_pattern != 0);
+
+  try
+    {
+// The directory is created if needed; if this fails, so does the
+// writing of the file.
+      mkdir (cache_directory.c_str(), 0755);
+
+      ostringstream data;
+      {
+        boost::archive::binary_oarchive oa (data);
+        oa << key;
+        oa << tria_f << tria_s;
+        oa << numbering_f << numbering_s;
+        oa << save_sparsity;
+        if (save_sparsity)
+          oa << *fluid_pattern << *solid_pattern;
+      }
+      write_checkpoint (filename, data.str());
+
+      cout
+          << "Setup saved to "
+          << filename
+          << endl;
+    }
+  catch (const std::exception &exc)
+    {
+      cerr
+          << " Can't write the setup cache "
+          << filename
+          << ": "
+          << exc.what()
+          << endl;
+    }
+
+  numbering_f.clear ();
+  numbering_s.clear ();
+}
+
+
+template class SetupCache<2>;
+template class SetupCache<3>;
+
+template void final_dof_numbering (const DoFHandler<2> &,
+                                   vector<types::global_dof_index> &);
+template void final_dof_numbering (const DoFHandler<3> &,
+                                   vector<types::global_dof_index> &);
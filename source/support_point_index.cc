@@ -0,0 +1,208 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+
+#include "support_point_index.h"
+
+#include <deal.II/base/numbers.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <algorithm>
+#include <limits>
+
+
+namespace
+{
+// Ranges of the tree with at most this many entries are scanned
+// linearly.
+  const unsigned int leaf_size = 8;
+
+// Comparison of two dofs by one coordinate of their support points.
+  template <int dim>
+  struct CompareCoordinate
+  {
+    CompareCoordinate (const vector< Point<dim> > &points,
+                       const unsigned int coordinate)
+      :
+      points (points),
+      coordinate (coordinate)
+    {}
+
+    bool operator() (const unsigned int a, const unsigned int b) const
+    {
+      return points[a][coordinate] < points[b][coordinate];
+    }
+
+    const vector< Point<dim> > &points;
+    const unsigned int coordinate;
+  };
+}
+
+
+template <int dim>
+SupportPointIndex<dim>::SupportPointIndex ()
+{}
+
+
+template <int dim>
+void
+SupportPointIndex<dim>::initialize (const Mapping<dim> &mapping,
+                                    const DoFHandler<dim> &dh)
+{
+  support_points.resize (dh.n_dofs());
+  DoFTools::map_dofs_to_support_points (mapping, dh, support_points);
+
+  tree.resize (dh.n_dofs());
+  for (unsigned int i=0; i<tree.size(); ++i)
+    tree[i] = i;
+
+  build (0, tree.size(), 0);
+}
+
+
+template <int dim>
+void
+SupportPointIndex<dim>::build (const unsigned int begin,
+                               const unsigned int end,
+                               const unsigned int depth)
+{
+  if (end - begin <= leaf_size)
+    return;
+
+  const unsigned int mid = (begin + end)/2;
+  std::nth_element (tree.begin()+begin, tree.begin()+mid, tree.begin()+end,
+                    CompareCoordinate<dim> (support_points, depth % dim));
+
+  build (begin, mid, depth+1);
+  build (mid+1, end, depth+1);
+}
+
+
+template <int dim>
+void
+SupportPointIndex<dim>::find_nearest (const Point<dim> &p,
+                                      const unsigned int begin,
+                                      const unsigned int end,
+                                      const unsigned int depth,
+                                      unsigned int &best,
+                                      double &best_distance_square) const
+{
+  if (end - begin <= leaf_size)
+    {
+      for (unsigned int i=begin; i<end; ++i)
+        {
+          const double d2 = (p - support_points[tree[i]]).norm_square();
+          if (d2 < best_distance_square)
+            {
+              best_distance_square = d2;
+              best = tree[i];
+            }
+        }
+      return;
+    }
+
+  const unsigned int mid = (begin + end)/2;
+  const unsigned int coordinate = depth % dim;
+  const double offset = p[coordinate] - support_points[tree[mid]][coordinate];
+
+  const double d2 = (p - support_points[tree[mid]]).norm_square();
+  if (d2 < best_distance_square)
+    {
+      best_distance_square = d2;
+      best = tree[mid];
+    }
+
+// Visit first the side of the splitting plane containing the point,
+// then the other one if it can contain a closer support point.
+  if (offset <= 0)
+    {
+      find_nearest (p, begin, mid, depth+1, best, best_distance_square);
+      if (offset*offset < best_distance_square)
+        find_nearest (p, mid+1, end, depth+1, best, best_distance_square);
+    }
+  else
+    {
+      find_nearest (p, mid+1, end, depth+1, best, best_distance_square);
+      if (offset*offset < best_distance_square)
+        find_nearest (p, begin, mid, depth+1, best, best_distance_square);
+    }
+}
+
+
+template <int dim>
+void
+SupportPointIndex<dim>::find_within_radius (const Point<dim> &p,
+                                            const double radius,
+                                            const unsigned int begin,
+                                            const unsigned int end,
+                                            const unsigned int depth,
+                                            vector<unsigned int> &dofs) const
+{
+  const double radius_square = radius*radius;
+
+  if (end - begin <= leaf_size)
+    {
+      for (unsigned int i=begin; i<end; ++i)
+        if ((p - support_points[tree[i]]).norm_square() <= radius_square)
+          dofs.push_back (tree[i]);
+      return;
+    }
+
+  const unsigned int mid = (begin + end)/2;
+  const unsigned int coordinate = depth % dim;
+  const double offset = p[coordinate] - support_points[tree[mid]][coordinate];
+
+  if ((p - support_points[tree[mid]]).norm_square() <= radius_square)
+    dofs.push_back (tree[mid]);
+
+  if (offset <= radius)
+    find_within_radius (p, radius, begin, mid, depth+1, dofs);
+  if (offset >= -radius)
+    find_within_radius (p, radius, mid+1, end, depth+1, dofs);
+}
+
+
+template <int dim>
+vector<unsigned int>
+SupportPointIndex<dim>::nearest (const vector< Point<dim> > &points) const
+{
+  Assert (tree.size() > 0, ExcNotInitialized());
+
+  vector<unsigned int> dofs (points.size(), numbers::invalid_unsigned_int);
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      double best_distance_square = std::numeric_limits<double>::max();
+      find_nearest (points[i], 0, tree.size(), 0, dofs[i], best_distance_square);
+    }
+  return dofs;
+}
+
+
+template <int dim>
+vector< vector<unsigned int> >
+SupportPointIndex<dim>::within_radius (const vector< Point<dim> > &points,
+                                       const double radius) const
+{
+  vector< vector<unsigned int> > dofs (points.size());
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      find_within_radius (points[i], radius, 0, tree.size(), 0, dofs[i]);
+      std::sort (dofs[i].begin(), dofs[i].end());
+    }
+  return dofs;
+}
+
+
+template class SupportPointIndex<2>;
+template class SupportPointIndex<3>;
@@ -0,0 +1,54 @@
+// Copyright (C) 2014 by Luca Heltai (1), Saswati Roy (2), and
+// Francesco Costanzo (3)
+//
+// (1) Scuola Internazionale Superiore di Studi Avanzati
+//     E-mail: luca.heltai@sissa.it
+// (2) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: sur164@psu.edu
+// (3) Center for Neural Engineering, The Pennsylvania State University
+//     E-Mail: costanzo@engr.psu.edu
+//
+// This file is subject to LGPL and may not be distributed without
+// copyright and license information. Please refer to the webpage
+// http://www.dealii.org/ -> License for the text and further
+// information on this license.
+#include "vector_kernels.h"
+
+#include <deal.II/base/parallel.h>
+
+
+namespace
+{
+// Vectors shorter than this are not split among threads.
+  const unsigned int grainsize = 4096;
+}
+
+
+void
+time_derivative (const BlockVector<double> &xi,
+                 const BlockVector<double> &previous_xi,
+                 const double dt,
+                 BlockVector<double> &xit)
+{
+  AssertDimension (xi.n_blocks(), previous_xi.n_blocks());
+  AssertDimension (xi.n_blocks(), xit.n_blocks());
+
+  const double inv_dt = 1./dt;
+  auto difference_quotient = [inv_dt] (const double x, const double x_old)
+  {
+    return (x - x_old)*inv_dt;
+  };
+
+  for (unsigned int b=0; b<xi.n_blocks(); ++b)
+    {
+      AssertDimension (xi.block(b).size(), previous_xi.block(b).size());
+      AssertDimension (xi.block(b).size(), xit.block(b).size());
+
+      parallel::transform (xi.block(b).begin(),
+                           xi.block(b).end(),
+                           previous_xi.block(b).begin(),
+                           xit.block(b).begin(),
+                           difference_quotient,
+                           grainsize);
+    }
+}
@@ -0,0 +1,182 @@
+#include "../tests.h"
+
+// Detection of uniform Cartesian grids by CartesianGridLocator, and
+// comparison of the cells and reference coordinates it finds with those
+// of a search in the triangulation.
+
+#include "cartesian_grid_locator.h"
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+
+template <int dim>
+void
+check_detection (Triangulation<dim> &tria,
+                 const std::string &label)
+{
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dh (tria);
+  dh.distribute_dofs (fe);
+
+  CartesianGridLocator<dim> locator;
+  deallog << label << ": cartesian " << locator.initialize (dh) << std::endl;
+}
+
+
+template <int dim>
+void
+test ()
+{
+  deallog << "dim " << dim << std::endl;
+
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_L (tria);
+    tria.refine_global (1);
+    check_detection (tria, "hyper L");
+  }
+
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_cube (tria);
+    tria.refine_global (2);
+    tria.begin_active()->set_refine_flag ();
+    tria.execute_coarsening_and_refinement ();
+    check_detection (tria, "locally refined cube");
+  }
+
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_ball (tria);
+    check_detection (tria, "ball");
+  }
+
+// A box of 4 x 3 (x 2) cells of size 0.5, refined once.
+  std::vector<unsigned int> repetitions (dim);
+  Point<dim> upper_corner;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      repetitions[d] = 4-d;
+      upper_corner[d] = 0.5*(4-d);
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_rectangle (tria, repetitions, Point<dim>(), upper_corner);
+  tria.refine_global (1);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dh (tria);
+  dh.distribute_dofs (fe);
+
+  CartesianGridLocator<dim> locator;
+  deallog << "refined box: cartesian " << locator.initialize (dh) << std::endl;
+
+// Points of a lattice not aligned with the cells, none of them on a
+// face.
+  std::vector< Point<dim> > points;
+  const unsigned int n_points[] = {7, 7, 5};
+  const double first[] = {0.11, 0.07, 0.05};
+  const double spacing[] = {0.27, 0.23, 0.19};
+  const unsigned int n_total = n_points[0] * n_points[1] * (dim == 3 ? n_points[2] : 1);
+  for (unsigned int i=0; i<n_total; ++i)
+    {
+      Point<dim> p;
+      unsigned int index = i;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          p[d] = first[d] + spacing[d]*(index % n_points[d]);
+          index /= n_points[d];
+        }
+      points.push_back (p);
+    }
+
+  MappingQ1<dim> mapping;
+  unsigned int n_located = 0, n_other_cell = 0, n_other_unit_point = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      typename CartesianGridLocator<dim>::cell_iterator cell;
+      Point<dim> unit_point;
+      if (!locator.locate (points[i], cell, unit_point))
+        continue;
+      ++n_located;
+
+      const std::pair<typename DoFHandler<dim>::active_cell_iterator, Point<dim> >
+      found = GridTools::find_active_cell_around_point (mapping, dh, points[i]);
+      if (found.first != cell)
+        ++n_other_cell;
+      else if (found.second.distance (unit_point) > 1e-10)
+        ++n_other_unit_point;
+    }
+  deallog << n_located << " of " << points.size() << " points located, "
+          << n_other_cell << " in another cell than found by a search, "
+          << n_other_unit_point << " at other reference coordinates" << std::endl;
+
+  std::vector<typename CartesianGridLocator<dim>::cell_iterator> cells;
+  std::vector< std::vector< Point<dim> > > qpoints;
+  std::vector< std::vector<unsigned int> > maps;
+  const unsigned int n_cells = locator.compute_point_locations (points, cells, qpoints, maps);
+
+  unsigned int n_grouped = 0, n_different = 0;
+  for (unsigned int c=0; c<n_cells; ++c)
+    for (unsigned int i=0; i<maps[c].size(); ++i)
+      {
+        ++n_grouped;
+        typename CartesianGridLocator<dim>::cell_iterator cell;
+        Point<dim> unit_point;
+        locator.locate (points[maps[c][i]], cell, unit_point);
+        if (cell != cells[c] || unit_point.distance (qpoints[c][i]) > 1e-10)
+          ++n_different;
+      }
+  deallog << "point locations: " << n_grouped << " points in " << n_cells
+          << " cells, " << n_different << " different from locate" << std::endl;
+
+// The upper corner of the grid belongs to the last cell, of which it is
+// the last vertex.
+  {
+    typename CartesianGridLocator<dim>::cell_iterator cell;
+    Point<dim> unit_point;
+    const bool located = locator.locate (upper_corner, cell, unit_point);
+    deallog << "upper corner: located " << located << ", vertex of the cell "
+            << (cell->vertex (GeometryInfo<dim>::vertices_per_cell-1)
+                .distance (upper_corner) < 1e-10)
+            << std::endl;
+  }
+
+// A point outside of the grid is not located.
+  {
+    Point<dim> outside = upper_corner;
+    outside[0] += 0.5;
+
+    typename CartesianGridLocator<dim>::cell_iterator cell;
+    Point<dim> unit_point;
+    deallog << "outside point: located " << locator.locate (outside, cell, unit_point)
+            << std::endl;
+
+    points.push_back (outside);
+    try
+      {
+        locator.compute_point_locations (points, cells, qpoints, maps);
+        deallog << "point locations: accepted" << std::endl;
+      }
+    catch (const std::exception &)
+      {
+        deallog << "point locations: rejected" << std::endl;
+      }
+  }
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
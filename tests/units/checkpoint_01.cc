@@ -0,0 +1,80 @@
+#include "../tests.h"
+
+// Write a checkpoint and read it back, and check that truncated and
+// corrupted files, and files that are not checkpoints, are rejected.
+
+#include "checkpoint.h"
+
+#include <cstdio>
+
+
+void
+check_rejected (const std::string &filename,
+                const std::string &label)
+{
+  try
+    {
+      read_checkpoint (filename);
+      deallog << label << ": accepted" << std::endl;
+    }
+  catch (const std::exception &)
+    {
+      deallog << label << ": rejected" << std::endl;
+    }
+}
+
+
+std::string
+file_content (const std::string &filename)
+{
+  std::ifstream in (filename.c_str(), std::ios::binary);
+  std::ostringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+
+void
+write_content (const std::string &filename,
+               const std::string &content)
+{
+  std::ofstream out (filename.c_str(), std::ios::binary);
+  out << content;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  const std::string data = "The state of the computation.";
+  write_checkpoint ("state.bin", data);
+  deallog << "exists: " << file_exists ("state.bin") << std::endl;
+  deallog << "temporary file left: " << file_exists ("state.bin.tmp") << std::endl;
+  deallog << "read back: " << read_checkpoint ("state.bin") << std::endl;
+
+  const std::string content = file_content ("state.bin");
+
+  write_content ("truncated.bin", content.substr (0, content.size()-5));
+  check_rejected ("truncated.bin", "truncated data");
+
+  write_content ("short_header.bin", content.substr (0, 12));
+  check_rejected ("short_header.bin", "truncated header");
+
+  std::string corrupted = content;
+  corrupted[corrupted.size()-3] ^= 1;
+  write_content ("corrupted.bin", corrupted);
+  check_rejected ("corrupted.bin", "corrupted data");
+
+  write_content ("text.bin", "Not a checkpoint at all.");
+  check_rejected ("text.bin", "other file");
+
+  check_rejected ("missing.bin", "missing file");
+
+  std::remove ("state.bin");
+  std::remove ("truncated.bin");
+  std::remove ("short_header.bin");
+  std::remove ("corrupted.bin");
+  std::remove ("text.bin");
+}
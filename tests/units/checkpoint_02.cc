@@ -0,0 +1,107 @@
+#include "../tests.h"
+
+// Rotation of a series of checkpoints: only the last n_kept are listed
+// and kept on disk, a series continues after a restart, the checkpoints
+// after the one a restart starts from are dropped, and writing the same
+// step twice does not list it twice.
+
+#include "checkpoint.h"
+
+#include <cstdio>
+
+
+void
+print_series (const std::string &prefix,
+              const unsigned int last_step)
+{
+  const std::vector<std::string> names = complete_checkpoints (prefix);
+  deallog << "listed:";
+  for (unsigned int i=0; i<names.size(); ++i)
+    deallog << " " << names[i];
+  deallog << std::endl;
+
+  deallog << "on disk:";
+  for (unsigned int step=1; step<=last_step; ++step)
+    {
+      const std::string name = (prefix + "checkpoint-"
+                                + Utilities::int_to_string (step, 5) + ".bin");
+      if (file_exists (name) && file_exists (name + ".done"))
+        deallog << " " << step;
+    }
+  deallog << std::endl;
+}
+
+
+void
+write_step (CheckpointWriter &writer,
+            const unsigned int step,
+            const std::string &run)
+{
+  std::string data = "step " + Utilities::int_to_string (step) + " of the " + run + " run";
+  writer.write (step, data);
+  deallog << "data left after write: " << data.size() << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  const std::string prefix = "rotation-";
+
+// Files left by a previous run of the test.
+  std::remove ((prefix + "checkpoints.txt").c_str());
+  for (unsigned int step=1; step<=6; ++step)
+    {
+      const std::string name = (prefix + "checkpoint-"
+                                + Utilities::int_to_string (step, 5) + ".bin");
+      std::remove (name.c_str());
+      std::remove ((name + ".done").c_str());
+    }
+
+  {
+    CheckpointWriter writer;
+    writer.initialize (prefix, 2, false);
+    for (unsigned int step=1; step<=4; ++step)
+      write_step (writer, step, "first");
+    deallog << "last step: " << writer.last_time_step() << std::endl;
+    print_series (prefix, 6);
+    deallog << "content: "
+            << read_checkpoint (prefix + "checkpoint-00004.bin") << std::endl;
+  }
+
+// A restart from the older of the two checkpoints: the newer one is
+// replaced when the same step is written again.
+  {
+    CheckpointWriter writer;
+    writer.initialize (prefix, 2, false);
+    writer.restored (prefix + "checkpoint-00003.bin");
+
+    write_step (writer, 4, "second");
+    print_series (prefix, 6);
+    deallog << "content: "
+            << read_checkpoint (prefix + "checkpoint-00004.bin") << std::endl;
+
+    write_step (writer, 5, "second");
+    print_series (prefix, 6);
+  }
+
+// A restart from the last checkpoint, which is written again, and the
+// series continued in the background.
+  {
+    CheckpointWriter writer;
+    writer.initialize (prefix, 2, true);
+    writer.restored (prefix + "checkpoint-00005.bin");
+
+    write_step (writer, 5, "third");
+    writer.wait ();
+    print_series (prefix, 6);
+    deallog << "content: "
+            << read_checkpoint (prefix + "checkpoint-00005.bin") << std::endl;
+
+    write_step (writer, 6, "third");
+    writer.wait ();
+    print_series (prefix, 6);
+  }
+}
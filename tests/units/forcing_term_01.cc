@@ -0,0 +1,65 @@
+#include "../tests.h"
+
+// Forcing terms of the inexact Newton method for given sequences of
+// residual norms: the Eisenstat-Walker choice decreases with the
+// residual, subject to its safeguards, and the constant choice only
+// increases to avoid solving more accurately than the Newton tolerance.
+
+#include "inexact_newton.h"
+
+
+std::string
+format (const double value)
+{
+  std::ostringstream s;
+  s << std::scientific << std::setprecision (2) << value;
+  return s.str();
+}
+
+
+void
+run_step (ForcingTerm &forcing_term,
+          const std::vector<double> &norms)
+{
+  forcing_term.begin_step ();
+  for (unsigned int i=0; i<norms.size(); ++i)
+    {
+      deallog << "residual " << format (norms[i])
+              << ", eta " << format (forcing_term.value (norms[i]))
+              << std::endl;
+      forcing_term.linear_solve_done (10*(i+1));
+    }
+  deallog << forcing_term.n_linear_iterations << " linear iterations in "
+          << forcing_term.n_linear_solves << " solves" << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+// A fast decrease of the residual, down to the Newton tolerance.
+  const double converging[] = {1, 0.5, 5e-2, 1e-4, 1e-9};
+
+// A residual that does not decrease.
+  const double stagnating[] = {1, 2, 1.8};
+
+  {
+    deallog << "Eisenstat-Walker" << std::endl;
+    ForcingTerm forcing_term;
+    forcing_term.initialize (ForcingTerm::eisenstat_walker, 0.5, 0.9, 1e-10);
+    run_step (forcing_term, std::vector<double> (converging, converging+5));
+    run_step (forcing_term, std::vector<double> (stagnating, stagnating+3));
+    deallog << "total: " << forcing_term.n_total_linear_iterations
+            << " linear iterations in " << forcing_term.n_total_linear_solves
+            << " solves" << std::endl;
+  }
+
+  {
+    deallog << "constant" << std::endl;
+    ForcingTerm forcing_term;
+    forcing_term.initialize (ForcingTerm::constant, 1e-3, 0.9, 1e-10);
+    run_step (forcing_term, std::vector<double> (converging, converging+5));
+  }
+}
@@ -0,0 +1,128 @@
+#include "../tests.h"
+
+// Drive NewtonPolicy with given sequences of residual norms, the way the
+// Newton loop of IFEM::run does, and print when the Jacobian is
+// refreshed (R) or reused (-), and when the iteration has converged.
+
+#include "newton_policy.h"
+
+
+void
+run_step (NewtonPolicy &policy,
+          const std::vector<double> &norms)
+{
+  policy.begin_step ();
+
+  std::string decisions;
+  bool converged = false;
+  try
+    {
+      for (unsigned int i=0; i<norms.size(); ++i)
+        {
+          const bool refresh = policy.refresh_requested ();
+          if (refresh)
+            policy.jacobian_refreshed ();
+
+          if (policy.converged (norms[i]))
+            {
+              converged = true;
+              break;
+            }
+
+          if (!refresh && policy.refresh_requested())
+            {
+              policy.jacobian_refreshed ();
+              decisions += " R";
+            }
+          else if (!refresh)
+            {
+              policy.jacobian_reused ();
+              decisions += " -";
+            }
+          else
+            decisions += " R";
+
+          policy.update_computed (norms[i]);
+        }
+    }
+  catch (const std::exception &)
+    {
+      deallog << "no convergence after " << policy.n_iterations
+              << " iterations" << std::endl;
+      return;
+    }
+
+  deallog << "Jacobian:" << decisions << std::endl;
+  deallog << (converged ? "converged" : "not converged") << " in "
+          << policy.n_iterations << " iterations, refreshed "
+          << policy.n_refreshes << " times, reused "
+          << policy.n_reuses << " times" << std::endl;
+}
+
+
+std::vector<double>
+norms (const double *values,
+       const unsigned int n)
+{
+  return std::vector<double> (values, values+n);
+}
+
+
+int
+main()
+{
+  initlog();
+
+  const double fast[] = {1, 1e-1, 1e-2, 1e-3, 1e-9};
+  const double slow[] = {1, 0.8, 8e-2, 8e-3, 1e-9};
+  const double relative[] = {10, 1, 5e-3};
+  const double stagnating[] = {1, 0.4, 0.16, 0.064, 0.0256, 0.01024};
+
+  {
+    deallog << "contraction" << std::endl;
+    NewtonPolicy policy;
+    policy.initialize (NewtonPolicy::contraction, 1e-8, 0, 0.5, 4, false, false);
+
+// The first step factorizes the Jacobian, which is kept while the
+// residual decreases fast enough, also in the next step.
+    run_step (policy, norms (fast, 5));
+    run_step (policy, norms (fast, 5));
+    run_step (policy, norms (slow, 5));
+
+// A residual that decreases, but not fast enough to converge within
+// the maximum number of iterations.
+    run_step (policy, norms (stagnating, 6));
+
+    deallog << "total: " << policy.n_total_iterations << " iterations, "
+            << policy.n_total_refreshes << " refreshes, "
+            << policy.n_total_reuses << " reuses" << std::endl;
+  }
+
+  {
+    deallog << "contraction, relative tolerance" << std::endl;
+    NewtonPolicy policy;
+    policy.initialize (NewtonPolicy::contraction, 1e-8, 1e-3, 0.5, 4, false, true);
+
+// Every step starts with a new Jacobian.
+    run_step (policy, norms (fast, 5));
+    run_step (policy, norms (relative, 3));
+  }
+
+  {
+    deallog << "legacy" << std::endl;
+    NewtonPolicy policy;
+    policy.initialize (NewtonPolicy::legacy, 1e-8, 0, 0.5, 4, false, false);
+
+// The Jacobian is refreshed after any update computed from a residual
+// larger than 1e-2, however fast the convergence.
+    run_step (policy, norms (fast, 5));
+    run_step (policy, norms (slow, 5));
+  }
+
+  {
+    deallog << "legacy, continuously" << std::endl;
+    NewtonPolicy policy;
+    policy.initialize (NewtonPolicy::legacy, 1e-8, 0, 0.5, 4, true, false);
+    run_step (policy, norms (fast, 5));
+  }
+}
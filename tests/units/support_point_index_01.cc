@@ -0,0 +1,127 @@
+#include "../tests.h"
+
+// Compare the queries of SupportPointIndex with a scan of all the support
+// points. The support points of a uniform grid are used as query points
+// with a radius equal to the mesh size, so that the neighbours of each
+// point are exactly at the radius and must be found.
+
+#include "support_point_index.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <algorithm>
+#include <limits>
+
+
+template <int dim>
+vector<unsigned int>
+scan_within_radius (const SupportPointIndex<dim> &index,
+                    const Point<dim> &p,
+                    const double radius)
+{
+  vector<unsigned int> dofs;
+  for (unsigned int i=0; i<index.size(); ++i)
+    if ((p - index.support_point(i)).norm_square() <= radius*radius)
+      dofs.push_back (i);
+  return dofs;
+}
+
+
+template <int dim>
+unsigned int
+scan_nearest (const SupportPointIndex<dim> &index,
+              const Point<dim> &p)
+{
+  unsigned int best = numbers::invalid_unsigned_int;
+  double best_distance_square = std::numeric_limits<double>::max();
+  for (unsigned int i=0; i<index.size(); ++i)
+    if ((p - index.support_point(i)).norm_square() < best_distance_square)
+      {
+        best_distance_square = (p - index.support_point(i)).norm_square();
+        best = i;
+      }
+  return best;
+}
+
+
+template <int dim>
+void
+check_within_radius (const SupportPointIndex<dim> &index,
+                     const vector< Point<dim> > &points,
+                     const double radius,
+                     const std::string &label)
+{
+  const vector< vector<unsigned int> > dofs = index.within_radius (points, radius);
+
+  unsigned int n_found = 0, n_different = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      n_found += dofs[i].size();
+      if (dofs[i] != scan_within_radius (index, points[i], radius))
+        ++n_different;
+    }
+  deallog << label << ": " << n_found << " found, "
+          << n_different << " different from a scan" << std::endl;
+}
+
+
+template <int dim>
+void
+test (const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dh (tria);
+  dh.distribute_dofs (fe);
+
+  MappingQ1<dim> mapping;
+  SupportPointIndex<dim> index;
+  index.initialize (mapping, dh);
+
+  const double h = 1.0/(1 << n_refinements);
+  deallog << "dim " << dim << ", support points: " << index.size() << std::endl;
+
+  vector< Point<dim> > points (index.size());
+  for (unsigned int i=0; i<index.size(); ++i)
+    points[i] = index.support_point(i);
+  check_within_radius (index, points, h, "support points, radius h");
+
+// Points away from the support points, some of them outside the grid.
+// Each is closer than h/2 along every direction to the support point it
+// was moved from, which is therefore the only nearest one.
+  Point<dim> shift;
+  for (unsigned int d=0; d<dim; ++d)
+    shift[d] = (0.3 - 0.11*d)*h;
+  for (unsigned int i=0; i<points.size(); ++i)
+    points[i] += shift;
+  check_within_radius (index, points, 1.5*h, "shifted points, radius 1.5h");
+
+  const vector<unsigned int> nearest = index.nearest (points);
+  unsigned int n_different = 0, n_moved = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      if (nearest[i] != scan_nearest (index, points[i]))
+        ++n_different;
+      if (nearest[i] != i)
+        ++n_moved;
+    }
+  deallog << "nearest: " << n_different << " different from a scan, "
+          << n_moved << " not the original support point" << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2> (3);
+  test<3> (2);
+}